@@ -22,7 +22,9 @@
 #define NULL (void *) 0		/* por si acaso no esta ya definida */
 #endif
 
-#define MAX_PROC 10		/* dimension de tabla de procesos */
+#define MAX_PROC 4096		/* maximo de procesos vivos a la vez */
+#define BCPS_POR_BLOQUE 64	/* la tabla de procesos crece de este modo */
+#define TAM_HASH_PIDS 256	/* entradas de la tabla hash de pids */
 
 #define TAM_PILA 32768
 
@@ -73,6 +75,81 @@
 			  abiertos un proceso */
 #define MAX_NOM_MUT 8 /* longitud maxima de un nombre de mutex */
 
+/* constantes usadas en implementacion de semaforos y variables condicion */
+#define NUM_SEM 16 /* numero total de semaforos en el sistema */
+#define NUM_COND 16 /* numero total de variables condicion en el sistema */
+/* sus nombres tienen la misma longitud maxima que los de los mutex */
+
+/* constantes usadas en implementacion de cerrojos de lectores/escritores */
+#define NUM_CERROJOS 16 /* numero total de cerrojos en el sistema */
+#define PREF_LECTORES 0 /* los lectores entran aunque haya escritores esperando */
+#define PREF_ESCRITORES 1 /* un escritor esperando impide la entrada de lectores */
+
+/* constante usada en implementacion de barreras */
+#define NUM_BARRERAS 16 /* numero total de barreras en el sistema */
+
+/* numero maximo de descriptores (de cualquier tipo) por proceso */
+#define NUM_DESC_PROC 16
+
+/* constantes usadas en implementacion de tuberias */
+#define NUM_TUBERIAS 16 /* numero total de tuberias en el sistema */
+#define TAM_BUF_TUBERIA 4096 /* bytes del buffer de cada tuberia */
+
+/* constante usada en implementacion de segmentos de memoria compartida */
+#define NUM_SEGMENTOS 16 /* numero total de segmentos en el sistema */
+
+/* constante usada en implementacion de regiones transferibles */
+#define NUM_REGIONES 32 /* numero total de regiones en el sistema */
+
+/* constante usada en implementacion del paso de mensajes sincrono */
+#define TAM_MENSAJE 64 /* tamano maximo de un mensaje */
+
+/* constantes usadas en implementacion de avisos asincronos */
+#define TAM_PILA_AVISOS 8192 /* pila en la que se ejecuta el manejador */
+#define AVISO_ALARMA 0x40000000 /* aviso que genera el kernel con alarma_aviso */
+
+/* constantes usadas en implementacion del sistema de ficheros en memoria */
+#define NUM_INODOS 64 /* ficheros y directorios del sistema */
+#define NUM_FICH_ABIERTOS 32 /* aperturas simultaneas en todo el sistema */
+#define MAX_NOM_FICH 16 /* longitud maxima de cada componente de una ruta */
+#define TAM_PAGINA 4096 /* unidad de almacenamiento de los ficheros */
+#define MAX_PAG_FICHERO 256 /* tamano maximo de fichero: 1 MB */
+
+/* constantes usadas en implementacion del disco y su cache de bloques */
+#define FICHERO_DISCO "disco.img" /* fichero del anfitrion que hace de disco */
+#define TAM_BLOQUE 4096 /* bytes por bloque */
+#define NUM_BLOQUES 4096 /* bloques del disco (16 MB) */
+#define MAX_BUFFERS 256 /* tamano maximo de la cache de bloques */
+#define BUFFERS_INICIALES 64 /* tamano inicial de la cache */
+#define BLOQUES_ADELANTADOS 8 /* lectura adelantada en accesos secuenciales */
+#define TICKS_VOLCADO 100 /* periodo de escritura de bloques modificados */
+
+/* constantes usadas en implementacion de la cache de imagenes */
+#define NUM_IMAGENES 32 /* programas distintos en la cache */
+#define MAX_NOM_PROG 32 /* los nombres mas largos no se guardan */
+#define IMAGENES_LIBRES 8 /* imagenes sin procesos que se conservan */
+
+/* constantes usadas en implementacion de la reserva de pilas */
+#define MAX_PILAS_RESERVA 256 /* pilas que puede guardar la reserva */
+#define PILAS_LIBRES 16 /* pilas que se conservan sin usar */
+#define TICKS_RECORTE_PILAS 100 /* inactividad antes de recortar la reserva */
+#define TAM_PILA_MIN 16384 /* pila mas pequena de crear_proceso_con_pila */
+#define TAM_PILA_MAX (8*1024*1024) /* y mas grande */
+#define TAM_PILA_EXCEPCIONES 65536 /* pila para tratar desbordamientos */
+
+/* constantes usadas en implementacion del reclamo de pilas */
+#define TICKS_RECLAMO 500 /* bloqueo tras el que se reclama la pila */
+#define TICKS_REVISION_RECLAMO 10 /* cada cuanto se buscan procesos */
+
+/* constante usada en implementacion de crear_procesos */
+#define MAX_CREAR_PROCESOS 256 /* procesos que crea una llamada */
+
+/* constante usada en implementacion de la medida del uso de pila */
+#define NUM_USOS_PILA 64 /* programas distintos que se miden */
+
+/* constante usada en implementacion de esperar_multiple */
+#define MAX_EVENTOS 8 /* numero maximo de eventos por llamada */
+
 /* constante usada en implementacion de manejador de terminal */
 #define TAM_BUF_TERM 8 /* tamao del buffer del terminal */
 
@@ -82,6 +159,8 @@
 // MUTEX//
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
+#define TRASPASO 2 /* flag que se suma al tipo: unlock cede el mutex
+		      directamente al primer proceso en espera */
 
 #endif /* _CONST_H */
 
@@ -30,37 +30,261 @@
  */
 typedef struct BCP_t *BCPptr;
 
+/*
+ * Tipos de evento que se pueden esperar con esperar_multiple
+ */
+#define EVENTO_MUTEX 0		/* el mutex esta libre */
+#define EVENTO_SEM 1		/* el semaforo tiene valor positivo */
+#define EVENTO_TERMINAL 2	/* hay caracteres en el buffer del terminal */
+
+/* Valor devuelto por esperar_multiple si vence el plazo */
+#define ESPERA_TIMEOUT -2
+
+/*
+ * Evento que se pasa a esperar_multiple
+ */
+struct evento {
+	int tipo;		/* EVENTO_MUTEX|EVENTO_SEM|EVENTO_TERMINAL */
+	unsigned int desc;	/* descriptor del objeto (no se usa con EVENTO_TERMINAL) */
+};
+
+/*
+ * Tipos de objeto del kernel a los que puede referirse un descriptor
+ */
+#define DESC_LIBRE 0
+#define DESC_MUTEX 1
+#define DESC_SEMAFORO 2
+#define DESC_CONDICION 3
+#define DESC_CERROJO 4
+#define DESC_BARRERA 5
+#define DESC_TUBERIA_LECTURA 6
+#define DESC_TUBERIA_ESCRITURA 7
+#define DESC_SEGMENTO 8
+#define DESC_FICHERO 9
+#define DESC_REGION 10
+
+/*
+ * Modo en que un proceso o hilo tiene un cerrojo de lectores/escritores
+ */
+#define EN_LECTURA 1
+#define EN_ESCRITURA 2
+
+/*
+ * Sistema de ficheros: tipos de inodo, modos de apertura y origen de
+ * posicionar
+ */
+#define INODO_LIBRE 0
+#define INODO_FICHERO 1
+#define INODO_DIRECTORIO 2
+
+#define F_LECTURA 1
+#define F_ESCRITURA 2
+#define F_CREAR 4
+#define F_TRUNCAR 8
+
+#define DESDE_INICIO 0
+#define DESDE_ACTUAL 1
+#define DESDE_FINAL 2
+
+/*
+ * Estado de un buffer de la cache de bloques (bits)
+ */
+#define BUF_VALIDO 1	/* contiene los datos del bloque */
+#define BUF_SUCIO 2	/* modificado y aun no escrito en disco */
+#define BUF_EN_ES 4	/* con una operacion pendiente en el disco */
+#define BUF_ERROR 8	/* la ultima operacion en el disco ha fallado */
+
+/*
+ * Situacion de un proceso respecto al paso de mensajes
+ */
+#define IPC_NADA 0
+#define IPC_ENVIANDO 1			/* bloqueado en enviar */
+#define IPC_LLAMANDO 2			/* bloqueado en llamar antes de que reciban */
+#define IPC_RECIBIENDO 3		/* bloqueado en recibir */
+#define IPC_ESPERANDO_RESPUESTA 4	/* bloqueado en llamar tras el recibir */
+
+/*
+ *
+ * Definicion del tipo que corresponde con la cabecera de una lista
+ * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
+ * procesos bloqueados en sem�foro, etc.).
+ *
+ */
+
+typedef struct{
+	BCPptr primero;
+	BCPptr ultimo;
+} lista_BCPs;
+
+/*
+ * Registro que deja un proceso al terminar hasta que su padre recoge el
+ * estado de salida. El BCP se libera sin esperar a que eso ocurra
+ */
+typedef struct zombi {
+	int pid;
+	int estado;
+	struct grupo_hilos *grupo;	/* hilos que siguen tras terminar el */
+					/* inicial o NULL si ya ha terminado */
+	struct zombi *siguiente;
+} zombi;
+
+/*
+ * Entrada del array de descriptores de un proceso
+ */
+typedef struct {
+	int tipo;	/* DESC_LIBRE|DESC_MUTEX|DESC_SEMAFORO|DESC_CONDICION|... */
+	int id;		/* posicion del objeto en su array global */
+	int usos;	/* hilos que tienen o esperan el cerrojo a traves de el */
+} descriptor;
+
+/*
+ * Lo que comparten los hilos de un proceso, ademas de la imagen. Se crea
+ * con el primer hilo y se libera al terminar el ultimo
+ */
+typedef struct grupo_hilos {
+	int hilos;		/* vivos */
+	descriptor descriptores[NUM_DESC_PROC];
+	int n_descriptores;
+	zombi *terminados;	/* hilos cuyo valor no se ha recogido */
+	lista_BCPs esperando;	/* hilos bloqueados en esperar_hilo */
+	zombi *registro;	/* el del proceso en su padre si el hilo */
+	int padre;		/* inicial ya ha terminado, o NULL */
+} grupo_hilos;
+
 typedef struct BCP_t {
-        int id;				/* ident. del proceso */
+        int id;				/* ident. del proceso (pid) */
         int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO*/
         contexto_t contexto_regs;	/* copia de regs. de UCP */
         void * pila;			/* dir. inicial de la pila */
+	int tam_pila;			/* bytes, sin la pagina de guarda */
+	void *reclamada_desde;		/* paginas de la pila devueltas al */
+	void *reclamada_hasta;		/* sistema mientras esta bloqueado */
+	unsigned int tick_bloqueo;	/* num_ticks al bloquearse */
+	int en_cola_reclamo;		/* bloqueado y aun sin reclamar */
+	BCPptr siguiente_reclamo;	/* cola de bloqueados por */
+	BCPptr anterior_reclamo;	/* orden de tick_bloqueo */
+	struct uso_pila_prog *uso_pila;	/* entrada de su programa o NULL */
+	BCPptr siguiente_uso_pila;	/* otro proceso vivo del programa */
+	unsigned int max_pila;		/* bytes de pila usados como maximo */
+	struct imagen_cache *imagen;	/* entrada de la cache o NULL */
 	BCPptr siguiente;		/* puntero a otro BCP */
+	BCPptr siguiente_hash;		/* siguiente en su entrada de hash_pids */
 	void *info_mem;			/* descriptor del mapa de memoria */
 
 	unsigned int segundosDormir; //Segundos dormir
 	
-	int n_descriptores; //MUTEX -> Guarda el no. de descriptores abiertos del proceso
+	int n_descriptores_propio;
+	int *n_descriptores; //MUTEX -> Guarda el no. de mutex abiertos del proceso (el propio o el de su grupo de hilos)
 	
-	int descriptores[NUM_MUT_PROC]; //MUTEX -> A�ADIDA. Array de descriptores
+	descriptor descriptores_propios[NUM_DESC_PROC];
+	descriptor *descriptores; //Array de descriptores (mutex, semaforos...), los propios o los de su grupo de hilos
+	char modo_cerrojos[NUM_DESC_PROC]; //EN_LECTURA|EN_ESCRITURA por descriptor de cerrojo; de cada hilo
 	
 	//Round robin
 	unsigned int slice; //Tiempo de ejecucion que le queda al proceso
 
+	//Tiempos
+	unsigned int ticks_usuario; //Ticks ejecutados en modo usuario
+	unsigned int ticks_sistema; //Ticks ejecutados en modo sistema
+
+	//Espera multiple. En los eventos el descriptor se sustituye por la
+	//posicion del objeto en su array global
+	struct evento eventos[MAX_EVENTOS];
+	int n_eventos;
+	int ticks_timeout; //Ticks que le quedan de espera (-1 sin limite)
+	int evento_listo; //Resultado de la espera
+
+	//Paso de mensajes. El mensaje se copia directamente del buffer del
+	//emisor al del receptor
+	int ipc_estado; //IPC_NADA|IPC_ENVIANDO|IPC_LLAMANDO|...
+	int ipc_pid; //Proceso con el que se comunica (-1 cualquiera al recibir)
+	char *ipc_buf; //Buffer del mensaje en el espacio del usuario
+	int ipc_tam; //Tamano del mensaje o capacidad del buffer al recibir
+	int ipc_resultado; //Lo que devuelve la llamada al despertar
+	lista_BCPs emisores; //Bloqueados en enviar o llamar hasta que haga recibir
+
+	//Avisos asincronos
+	int avisos_pendientes; //Un bit por aviso aun no entregado
+	void *entrada_avisos; //Funcion de la biblioteca que llama al manejador
+	void *pila_avisos;
+	int en_manejador;
+	contexto_t contexto_interrumpido; //Donde sigue el proceso tras el manejador
+	int ticks_alarma; //Ticks hasta el AVISO_ALARMA (0 sin alarma)
+	BCPptr siguiente_alarma; //En procs_alarma mientras ticks_alarma > 0
+
+	//Procesos hijos
+	int padre; //pid del padre, que puede haber terminado (-1 init)
+	int hijos_vivos;
+	struct zombi *zombis; //Hijos terminados cuyo estado no se ha recogido
+	int esperando_hijo; //Bloqueado en esperar_proceso
+	int hijo_esperado; //pid por el que espera (-1 cualquiera)
+
+	//Hilos
+	struct grupo_hilos *grupo; //NULL si el proceso no ha creado hilos
+	void *funcion_hilo; //Lo que recoge la biblioteca al empezar el hilo
+	void *argumento_hilo;
+
 } BCP;
 
 /*
- *
- * Definicion del tipo que corresponde con la cabecera de una lista
- * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
- * procesos bloqueados en sem�foro, etc.).
- *
+ * Tipo usado por la llamada tiempos_proceso
  */
+struct tiempos_ejec {
+	int usuario;
+	int sistema;
+};
 
-typedef struct{
-	BCP *primero;
-	BCP *ultimo;
-} lista_BCPs;
+/*
+ * Tipo usado por la llamada estadisticas_disco
+ */
+struct estad_disco {
+	unsigned int aciertos;		/* bloques servidos desde la cache */
+	unsigned int fallos;		/* bloques que hubo que esperar al disco */
+	unsigned int lecturas;		/* lecturas hechas en el disco */
+	unsigned int adelantadas;	/* de ellas, de lectura adelantada */
+	unsigned int escrituras;	/* escrituras hechas en el disco */
+	unsigned int ticks_espera;	/* ticks bloqueados esperando al disco */
+};
+
+/*
+ * Tipo usado por la llamada estadisticas_imagenes
+ */
+struct estad_imagenes {
+	unsigned int aciertos;		/* procesos creados con la imagen en cache */
+	unsigned int fallos;		/* procesos que tuvieron que cargarla */
+};
+
+/*
+ * Tipo usado por la llamada estadisticas_pilas
+ */
+struct estad_pilas {
+	unsigned int reutilizadas;	/* pilas sacadas de la reserva */
+	unsigned int creadas;		/* pilas nuevas */
+	unsigned int liberadas;		/* pilas devueltas al HAL */
+	unsigned int libres;		/* pilas en la reserva */
+	unsigned int fallos_pagina;	/* de todo el sistema */
+	unsigned int residente_kb;	/* memoria residente del sistema */
+};
+
+/*
+ * Tipo usado por la llamada estadisticas_reclamo
+ */
+struct estad_reclamo {
+	unsigned int procesos;		/* pilas reclamadas */
+	unsigned int bytes_reclamados;
+	unsigned int restauraciones;
+	unsigned int us_restauracion;	/* total de todas ellas */
+};
+
+/*
+ * Tipo usado por la llamada uso_pila
+ */
+struct uso_pila {
+	unsigned int procesos;		/* terminados */
+	unsigned int maximo;		/* bytes, tambien de los vivos */
+	unsigned int medio;		/* bytes, de los terminados */
+	unsigned int vivos;
+};
 
 
 /*
@@ -70,10 +294,19 @@ typedef struct{
 BCP * p_proc_actual=NULL;
 
 /*
- * Variable global que representa la tabla de procesos
+ * Variables globales que representan la tabla de procesos. Los BCPs se
+ * reservan en bloques segun hacen falta y nunca se mueven, ya que las
+ * listas guardan punteros a ellos. Los libres forman una lista y los
+ * usados se localizan por su pid, que no coincide con su posicion, en
+ * una tabla hash
  */
 
-BCP tabla_procs[MAX_PROC];
+BCP *bloques_procs[MAX_PROC/BCPS_POR_BLOQUE];
+int num_bloques_procs=0;
+BCP *BCPs_libres=NULL;		/* pila enlazada por el campo siguiente */
+BCP *hash_pids[TAM_HASH_PIDS];
+int num_procesos=0;		/* procesos vivos */
+int siguiente_pid=0;
 
 /*
  * Variable global que representa la cola de procesos listos
@@ -92,10 +325,60 @@ typedef struct{
 
 //FUNCIONES AUXILIARES
 void cuentaAtrasBloqueados();
+void contabilizarTiempos();
+void volcar_estadisticas();
+void comprobar_esperas_multiples(int tick);
 
 int descriptor_libre();
 int nombres_iguales(char* nombre);
 int descriptor_mutex();
+int objeto_de_descriptor(unsigned int descriptor, int tipo);
+int cerrar_descriptor(unsigned int descriptor);
+void cerrar_descriptores();
+int mutex_de_descriptor(unsigned int descriptor);
+int cerrar_descriptor_mutex(unsigned int descriptor);
+int adquirir_mutex(int id);
+int cerrar_descriptor_sem(unsigned int descriptor);
+int cerrar_descriptor_cond(unsigned int descriptor);
+int cerrar_descriptor_cerrojo(unsigned int des);
+int cerrar_descriptor_barrera(unsigned int descriptor);
+int cerrar_descriptor_tuberia(unsigned int des);
+void heredar_descriptores(BCP *hijo);
+int cerrar_descriptor_segmento(unsigned int descriptor);
+void cancelar_mensajes();
+void entregar_avisos();
+void cuentaAtrasAlarmas();
+void quitar_alarma(BCP *proc);
+int cerrar_descriptor_fichero(unsigned int descriptor);
+void iniciar_disco();
+void int_disco();
+void cuentaAtrasVolcado();
+void proteger_regiones(BCP *proc);
+int cerrar_descriptor_region(unsigned int descriptor);
+void cancelar_regiones();
+void dejar_zombi(int estado, int ultimo_hilo);
+void liberar_zombis();
+void *obtener_imagen(BCP *proc, char *prog, void **pc);
+void *compartir_imagen(BCP *proc, BCP *modelo, void **pc);
+void copiar_parametro(void *destino, const void *origen, int n);
+void soltar_imagen(BCP *proc, int ultimo_proceso);
+void *obtener_pila(int tam);
+void devolver_pila(void *pila, int tam);
+void iniciar_pilas();
+void encolar_reclamo(BCP *proc);
+void restaurar_pila(BCP *proc);
+void cuentaAtrasReclamo();
+void rellenar_pila(void *pila, int tam);
+unsigned int medir_pila(BCP *proc);
+void asignar_uso_pila(BCP *proc, char *prog);
+void unir_uso_pila(BCP *proc, struct uso_pila_prog *uso);
+void anotar_uso_pila(BCP *proc);
+void volcar_uso_pilas();
+void cuentaAtrasEsperaBCP();
+int salir_del_grupo(int valor);
+void liberar_grupo();
+void cuentaAtrasPilas();
+void volcar_disco();
 
 
 /*
@@ -111,6 +394,82 @@ int abrir_mutex(char* nombre);
 int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
+int sis_tiempos_proceso();
+int sis_crear_sem();
+int sis_abrir_sem();
+int sis_esperar_sem();
+int sis_senalar_sem();
+int sis_cerrar_sem();
+int sis_crear_cond();
+int sis_abrir_cond();
+int sis_esperar_cond();
+int sis_senalar_cond();
+int sis_difundir_cond();
+int sis_cerrar_cond();
+int sis_crear_cerrojo();
+int sis_abrir_cerrojo();
+int sis_lock_lectura();
+int sis_lock_escritura();
+int sis_unlock_cerrojo();
+int sis_cerrar_cerrojo();
+int sis_crear_barrera();
+int sis_abrir_barrera();
+int sis_esperar_barrera();
+int sis_cerrar_barrera();
+int sis_estadisticas_mutex();
+int sis_leer_caracter();
+int sis_esperar_multiple();
+int sis_lock_varios();
+int sis_unlock_varios();
+int sis_crear_tuberia();
+int sis_leer_tuberia();
+int sis_escribir_tuberia();
+int sis_cerrar_tuberia();
+int sis_crear_segmento();
+int sis_asociar_segmento();
+int sis_desasociar_segmento();
+int sis_enviar();
+int sis_recibir();
+int sis_llamar();
+int sis_responder();
+int sis_responder_y_recibir();
+int sis_registrar_avisos();
+int sis_notificar();
+int sis_esperar_avisos();
+int sis_alarma_aviso();
+int sis_tomar_avisos();
+int sis_fin_avisos();
+int sis_abrir();
+int sis_leer_fichero();
+int sis_escribir_fichero();
+int sis_posicionar();
+int sis_cerrar_fichero();
+int sis_crear_directorio();
+int sis_borrar();
+int sis_leer_bloque();
+int sis_escribir_bloque();
+int sis_sincronizar();
+int sis_ajustar_cache();
+int sis_estadisticas_disco();
+int sis_crear_region();
+int sis_transferir_region();
+int sis_recibir_region();
+int sis_liberar_region();
+int sis_esperar_proceso();
+int sis_ajustar_cache_imagenes();
+int sis_estadisticas_imagenes();
+int sis_ajustar_pilas();
+int sis_estadisticas_pilas();
+int sis_crear_proceso_con_pila();
+int sis_ajustar_reclamo();
+int sis_estadisticas_reclamo();
+int sis_uso_pila();
+int sis_crear_proceso_esperando();
+int sis_crear_procesos();
+int sis_crear_hilo();
+int sis_tomar_hilo();
+int sis_esperar_hilo();
+int sis_ceder_procesador();
 /*
  * Variable global que contiene las rutinas que realizan cada llamada
  */
@@ -123,23 +482,115 @@ servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso},
 					{abrir_mutex},
 					{lock},
 					{unlock},
-					{cerrar_mutex}};
+					{cerrar_mutex},
+					{sis_tiempos_proceso},
+					{sis_crear_sem},
+					{sis_abrir_sem},
+					{sis_esperar_sem},
+					{sis_senalar_sem},
+					{sis_cerrar_sem},
+					{sis_crear_cond},
+					{sis_abrir_cond},
+					{sis_esperar_cond},
+					{sis_senalar_cond},
+					{sis_difundir_cond},
+					{sis_cerrar_cond},
+					{sis_crear_cerrojo},
+					{sis_abrir_cerrojo},
+					{sis_lock_lectura},
+					{sis_lock_escritura},
+					{sis_unlock_cerrojo},
+					{sis_cerrar_cerrojo},
+					{sis_crear_barrera},
+					{sis_abrir_barrera},
+					{sis_esperar_barrera},
+					{sis_cerrar_barrera},
+					{sis_estadisticas_mutex},
+					{sis_leer_caracter},
+					{sis_esperar_multiple},
+					{sis_lock_varios},
+					{sis_unlock_varios},
+					{sis_crear_tuberia},
+					{sis_leer_tuberia},
+					{sis_escribir_tuberia},
+					{sis_cerrar_tuberia},
+					{sis_crear_segmento},
+					{sis_asociar_segmento},
+					{sis_desasociar_segmento},
+					{sis_enviar},
+					{sis_recibir},
+					{sis_llamar},
+					{sis_responder},
+					{sis_responder_y_recibir},
+					{sis_registrar_avisos},
+					{sis_notificar},
+					{sis_esperar_avisos},
+					{sis_alarma_aviso},
+					{sis_tomar_avisos},
+					{sis_fin_avisos},
+					{sis_abrir},
+					{sis_leer_fichero},
+					{sis_escribir_fichero},
+					{sis_posicionar},
+					{sis_cerrar_fichero},
+					{sis_crear_directorio},
+					{sis_borrar},
+					{sis_leer_bloque},
+					{sis_escribir_bloque},
+					{sis_sincronizar},
+					{sis_ajustar_cache},
+					{sis_estadisticas_disco},
+					{sis_crear_region},
+					{sis_transferir_region},
+					{sis_recibir_region},
+					{sis_liberar_region},
+					{sis_esperar_proceso},
+					{sis_ajustar_cache_imagenes},
+					{sis_estadisticas_imagenes},
+					{sis_ajustar_pilas},
+					{sis_estadisticas_pilas},
+					{sis_crear_proceso_con_pila},
+					{sis_ajustar_reclamo},
+					{sis_estadisticas_reclamo},
+					{sis_uso_pila},
+					{sis_crear_proceso_esperando},
+					{sis_crear_procesos},
+					{sis_crear_hilo},
+					{sis_tomar_hilo},
+					{sis_esperar_hilo},
+					{sis_ceder_procesador}};
 
 // MUTEX
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+//Estadisticas de contencion de un mutex (tiempos en ticks). Solo cuentan
+//las adquisiciones del mutex, no los lock recursivos de su propietario
+struct estad_mutex {
+	unsigned int adquisiciones;
+	unsigned int adquisiciones_con_espera; //El proceso tuvo que bloquearse
+	unsigned int ticks_espera;
+	unsigned int max_ticks_espera;
+	unsigned int ticks_retencion; //Desde que se obtiene hasta que se libera
+	unsigned int max_ticks_retencion;
+	unsigned int max_esperando; //Longitud maxima de lista_proc_esperando_lock
+};
+
 //Estructura para el tipo mutex
 typedef struct {
-	char* nombre;
+	char nombre[MAX_NOM_MUT+1]; //Copia del nombre (el del usuario puede desaparecer)
 	int tipo; //Recursivo o no recursivo
-	int propietario; //Id del proceso due�o, es decir, el que ha hecho lock
-	int abierto; //Si no esta bierto = 0
+	int traspaso; //Si es 1, unlock cede el mutex directamente al primero en espera
+	int propietario; //Id del proceso due�o, es decir, el que ha hecho lock (-1 si libre)
+	int abierto; //Numero de descriptores abiertos sobre el mutex (0 si no existe)
 	int locked; //N�mero de veces que ha sido bloqueado(0 si esta desbloqueado)
 	int n_procesos_esperando; // numero de procesos esperando asociado a procesos_esperando
 
 	//Guarda los procesos bloqueados de cada mutex bloqueado
 	lista_BCPs lista_proc_esperando_lock;
+
+	unsigned int tick_adquisicion; //Tick en que lo obtuvo el propietario actual
+	struct estad_mutex estadisticas; //Se conservan hasta que se reutilice la entrada
 } mutex;
 
 //Array de mutex utilizados
@@ -151,6 +602,242 @@ int mutex_creados;
 //Lista de procesos bloqueados porque se habian creado el numero maximo de mutex permitidos
 lista_BCPs lista_bloq_mutex = { NULL, NULL };
 
+//DORMIR
+//Lista de procesos bloqueados en la llamada dormir
+lista_BCPs lista_dormidos = { NULL, NULL };
+
+//TIEMPOS
+//Ticks de reloj transcurridos desde el arranque
+unsigned int num_ticks;
+
+//Indica que el kernel esta accediendo a un parametro de usuario
+int acceso_parametro;
+
+// SEMAFOROS
+//Estructura para el tipo semaforo
+typedef struct {
+	char nombre[MAX_NOM_MUT+1];
+	int valor; //Valor del contador del semaforo
+	int abierto; //Numero de descriptores abiertos sobre el semaforo (0 si no existe)
+
+	//Procesos bloqueados en esperar_sem
+	lista_BCPs lista_proc_esperando;
+} semaforo;
+
+//Array de semaforos del sistema
+semaforo array_sem[NUM_SEM];
+
+// VARIABLES CONDICION
+//Estructura para el tipo variable condicion
+typedef struct {
+	char nombre[MAX_NOM_MUT+1];
+	int abierto; //Numero de descriptores abiertos sobre la condicion (0 si no existe)
+
+	//Procesos bloqueados en esperar_cond
+	lista_BCPs lista_proc_esperando;
+} condicion;
+
+//Array de variables condicion del sistema
+condicion array_cond[NUM_COND];
+
+// CERROJOS DE LECTORES/ESCRITORES
+//Estructura para el tipo cerrojo
+typedef struct {
+	char nombre[MAX_NOM_MUT+1];
+	int preferencia; //PREF_LECTORES o PREF_ESCRITORES
+	int abierto; //Numero de descriptores abiertos sobre el cerrojo (0 si no existe)
+	int lectores; //Numero de lectores que lo tienen
+	int escritor; //Id del escritor que lo tiene (-1 si ninguno)
+
+	//Procesos bloqueados en lock_lectura y en lock_escritura
+	lista_BCPs lista_lectores;
+	lista_BCPs lista_escritores;
+} cerrojo;
+
+//Array de cerrojos del sistema
+cerrojo array_cerrojos[NUM_CERROJOS];
+
+// BARRERAS
+//Estructura para el tipo barrera
+typedef struct {
+	char nombre[MAX_NOM_MUT+1];
+	int abierto; //Numero de descriptores abiertos sobre la barrera (0 si no existe)
+	int participantes; //Procesos que tienen que llegar para abrirla
+	int llegados; //Procesos que ya han llegado en la fase actual
+
+	//Procesos bloqueados en esperar_barrera
+	lista_BCPs lista_proc_esperando;
+} barrera;
+
+//Array de barreras del sistema
+barrera array_barreras[NUM_BARRERAS];
+
+// TUBERIAS
+//Estructura para el tipo tuberia. Los datos se guardan en un buffer
+//circular: ocupados bytes a partir de la posicion primero
+typedef struct {
+	char buffer[TAM_BUF_TUBERIA];
+	int primero;
+	int ocupados;
+	int lectores; //Descriptores abiertos del extremo de lectura
+	int escritores; //Descriptores abiertos del extremo de escritura
+				//(la tuberia esta libre si ambos son 0)
+
+	//Procesos bloqueados con la tuberia vacia y con la tuberia llena
+	lista_BCPs lista_lectores;
+	lista_BCPs lista_escritores;
+} tuberia;
+
+//Array de tuberias del sistema
+tuberia array_tuberias[NUM_TUBERIAS];
+
+// MEMORIA COMPARTIDA
+//Estructura para el tipo segmento. Como todos los procesos comparten el
+//espacio de direcciones, la zona es la misma para todos los que se asocian
+typedef struct {
+	char nombre[MAX_NOM_MUT+1];
+	void *dir;
+	int tam;
+	int abierto; //Numero de procesos asociados (0 si no existe)
+} segmento;
+
+//Array de segmentos del sistema
+segmento array_segmentos[NUM_SEGMENTOS];
+
+// REGIONES TRANSFERIBLES
+//Estructura para el tipo region. Las paginas solo son accesibles mientras
+//ejecuta su propietario; durante una transferencia no lo son para nadie
+typedef struct {
+	void *dir; //NULL si la entrada esta libre
+	int tam; //Multiplo de TAM_PAGINA
+	int propietario; //-1 mientras se transfiere
+	int destino; //Proceso que la tiene que recibir o -1
+	int origen; //Ultimo proceso que la transfirio
+	unsigned int orden; //Orden de transferencia
+	int accesible; //Proteccion actual de las paginas
+} region;
+
+//Array de regiones del sistema
+region array_regiones[NUM_REGIONES];
+
+//Procesos bloqueados en recibir_region
+lista_BCPs lista_espera_regiones;
+
+// CACHE DE IMAGENES
+//Imagen del HAL compartida por las instancias de un programa
+typedef struct imagen_cache {
+	char nombre[MAX_NOM_PROG+1];
+	void *mem; //NULL si la entrada esta libre
+	void *pc; //Punto de entrada
+	int refs; //Procesos vivos que la usan
+	unsigned int ultimo_uso; //Para expulsar por LRU las que no se usan
+} imagen_cache;
+
+imagen_cache array_imagenes[NUM_IMAGENES];
+int max_imagenes_libres = IMAGENES_LIBRES;
+struct estad_imagenes estadisticas_imagenes;
+
+// RESERVA DE PILAS
+int max_pilas_libres = PILAS_LIBRES;
+struct estad_pilas estadisticas_pilas;
+
+// RECLAMO DE PILAS
+unsigned int ticks_reclamo = TICKS_RECLAMO;
+struct estad_reclamo estadisticas_reclamo;
+//Bloqueados cuya pila aun no se ha reclamado, del mas antiguo al ultimo
+BCP *primero_reclamo = NULL;
+BCP *ultimo_reclamo = NULL;
+
+// USO DE PILA
+//Uso de pila de los procesos terminados de cada programa
+typedef struct uso_pila_prog {
+	char nombre[MAX_NOM_PROG+1]; //Vacio si la entrada esta libre
+	unsigned int procesos;
+	unsigned int maximo;
+	unsigned long total; //Para calcular la media
+	BCP *vivos; //Enlazados por siguiente_uso_pila
+} uso_pila_prog;
+
+uso_pila_prog array_usos_pila[NUM_USOS_PILA];
+
+// CREACION DE PROCESOS
+//Procesos bloqueados en crear_proceso_esperando por estar llena la tabla
+lista_BCPs lista_espera_BCP;
+
+// ESPERA DE PROCESOS HIJOS
+//Procesos bloqueados en esperar_proceso
+lista_BCPs lista_espera_hijos;
+
+// MENSAJES
+//Procesos bloqueados en recibir o esperando la respuesta de llamar
+lista_BCPs lista_bloq_ipc = { NULL, NULL };
+
+// AVISOS
+//Procesos bloqueados en esperar_avisos
+lista_BCPs lista_espera_avisos = { NULL, NULL };
+//Procesos con una alarma programada, enlazados por siguiente_alarma
+BCP *procs_alarma = NULL;
+
+// FICHEROS
+//Fichero o directorio. El espacio de nombres es un arbol: cada inodo
+//guarda su nombre y el de su directorio padre. El contenido de un fichero
+//se guarda en paginas que se reservan al escribir en ellas
+typedef struct {
+	int tipo; //INODO_LIBRE|INODO_FICHERO|INODO_DIRECTORIO
+	char nombre[MAX_NOM_FICH+1];
+	int padre; //Inodo del directorio que lo contiene (-1 si esta borrado)
+	int tam;
+	int abierto; //Aperturas activas (un fichero borrado se libera al llegar a 0)
+	char *paginas[MAX_PAG_FICHERO];
+} inodo;
+
+//Inodos del sistema. El 0 es el directorio raiz
+inodo array_inodos[NUM_INODOS];
+
+//Apertura de un fichero. Cada descriptor tiene la suya con su posicion
+typedef struct {
+	int inodo; //-1 si la entrada esta libre
+	int modo;
+	int posicion;
+} fichero_abierto;
+
+fichero_abierto array_fich_abiertos[NUM_FICH_ABIERTOS];
+
+// DISCO
+//Buffer de la cache de bloques. El hilo del anfitrion que hace las
+//operaciones pone terminada a 1 y int_disco completa la operacion
+typedef struct {
+	int bloque; //-1 si no tiene ninguno asignado
+	int estado; //BUF_VALIDO|BUF_SUCIO|BUF_EN_ES|BUF_ERROR
+	int escribiendo; //Tipo de la operacion pendiente
+	int error; //El hilo del anfitrion no ha podido completarla
+	int adelantado; //Leido por adelantado y aun no usado
+	volatile int terminada;
+	unsigned int ultimo_uso; //Para elegir victima LRU
+	char *datos;
+
+	//Procesos esperando a que termine la operacion pendiente
+	lista_BCPs lista_esperando;
+} buffer;
+
+buffer array_buffers[MAX_BUFFERS];
+int num_buffers; //Buffers en uso de la cache (<= MAX_BUFFERS)
+unsigned int reloj_lru;
+struct estad_disco estadisticas_disco;
+
+//TERMINAL
+//Buffer circular con los caracteres recibidos y aun no leidos
+char buffer_terminal[TAM_BUF_TERM];
+int primer_car_terminal;
+int num_car_terminal;
+
+//Lista de procesos bloqueados en leer_caracter
+lista_BCPs lista_bloq_terminal = { NULL, NULL };
+
+//ESPERA MULTIPLE
+//Lista de procesos bloqueados en esperar_multiple
+lista_BCPs lista_espera_multiple = { NULL, NULL };
+
 //ROUND ROBIN
 int ticksPorRodaja;
 BCPptr Proceso_Expulsar;
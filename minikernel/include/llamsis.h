@@ -19,7 +19,7 @@
 #define _LLAMSIS_H
 
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 10 //3
+#define NSERVICIOS 86 //3
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
@@ -33,6 +33,106 @@
 #define LOCK 7
 #define UNLOCK 8
 #define CERRAR_MUTEX 9
+//TIEMPOS
+#define TIEMPOS_PROCESO 10
+//SEMAFOROS
+#define CREAR_SEM 11
+#define ABRIR_SEM 12
+#define ESPERAR_SEM 13
+#define SENALAR_SEM 14
+#define CERRAR_SEM 15
+//VARIABLES CONDICION
+#define CREAR_COND 16
+#define ABRIR_COND 17
+#define ESPERAR_COND 18
+#define SENALAR_COND 19
+#define DIFUNDIR_COND 20
+#define CERRAR_COND 21
+//CERROJOS LECTORES/ESCRITORES
+#define CREAR_CERROJO 22
+#define ABRIR_CERROJO 23
+#define LOCK_LECTURA 24
+#define LOCK_ESCRITURA 25
+#define UNLOCK_CERROJO 26
+#define CERRAR_CERROJO 27
+//BARRERAS
+#define CREAR_BARRERA 28
+#define ABRIR_BARRERA 29
+#define ESPERAR_BARRERA 30
+#define CERRAR_BARRERA 31
+//ESTADISTICAS DE MUTEX
+#define ESTADISTICAS_MUTEX 32
+//TERMINAL
+#define LEER_CARACTER 33
+//ESPERA MULTIPLE
+#define ESPERAR_MULTIPLE 34
+//VARIOS MUTEX
+#define LOCK_VARIOS 35
+#define UNLOCK_VARIOS 36
+//TUBERIAS
+#define CREAR_TUBERIA 37
+#define LEER_TUBERIA 38
+#define ESCRIBIR_TUBERIA 39
+#define CERRAR_TUBERIA 40
+//MEMORIA COMPARTIDA
+#define CREAR_SEGMENTO 41
+#define ASOCIAR_SEGMENTO 42
+#define DESASOCIAR_SEGMENTO 43
+//MENSAJES
+#define ENVIAR 44
+#define RECIBIR 45
+#define LLAMAR 46
+#define RESPONDER 47
+#define RESPONDER_Y_RECIBIR 48
+//AVISOS
+#define REGISTRAR_AVISOS 49
+#define NOTIFICAR 50
+#define ESPERAR_AVISOS 51
+#define ALARMA_AVISO 52
+#define TOMAR_AVISOS 53
+#define FIN_AVISOS 54
+//FICHEROS
+#define ABRIR 55
+#define LEER_FICHERO 56
+#define ESCRIBIR_FICHERO 57
+#define POSICIONAR 58
+#define CERRAR_FICHERO 59
+#define CREAR_DIRECTORIO 60
+#define BORRAR 61
+//DISCO
+#define LEER_BLOQUE 62
+#define ESCRIBIR_BLOQUE 63
+#define SINCRONIZAR 64
+#define AJUSTAR_CACHE 65
+#define ESTADISTICAS_DISCO 66
+//REGIONES
+#define CREAR_REGION 67
+#define TRANSFERIR_REGION 68
+#define RECIBIR_REGION 69
+#define LIBERAR_REGION 70
+//ESPERA DE HIJOS
+#define ESPERAR_PROCESO 71
+//CACHE DE IMAGENES
+#define AJUSTAR_CACHE_IMAGENES 72
+#define ESTADISTICAS_IMAGENES 73
+//RESERVA DE PILAS
+#define AJUSTAR_PILAS 74
+#define ESTADISTICAS_PILAS 75
+#define CREAR_PROCESO_CON_PILA 76
+//RECLAMO DE PILAS
+#define AJUSTAR_RECLAMO 77
+#define ESTADISTICAS_RECLAMO 78
+//USO DE PILA
+#define USO_PILA 79
+//CREACION DE PROCESOS
+#define CREAR_PROCESO_ESPERANDO 80
+#define CREAR_PROCESOS 81
+//HILOS
+#define CREAR_HILO 82
+#define TOMAR_HILO 83
+#define ESPERAR_HILO 84
+//CESION DEL PROCESADOR
+#define CEDER_PROCESADOR 85
 
 #endif /* _LLAMSIS_H */
 
@@ -13,42 +13,147 @@
  *
  */
 
+#define _GNU_SOURCE	/* REG_RSP en ucontext.h */
 #include "kernel.h"	/* Contiene defs. usadas por este modulo */
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <stdio.h>
+#include <sys/time.h>
 
 /*
  *
  * Funciones relacionadas con la tabla de procesos:
- *	iniciar_tabla_proc buscar_BCP_libre
+ *	iniciar_tabla_proc ampliar_tabla_proc buscar_BCP_libre
+ *	devolver_BCP registrar_BCP liberar_BCP buscar_proceso
  *
  */
 
 /*
- * Funci�n que inicia la tabla de procesos
+ * Funci�n que inicia la tabla de procesos. Empieza vacia: los
+ * BCPs se reservan segun se van creando procesos
  */
 static void iniciar_tabla_proc(){
 	int i;
 
-	for (i=0; i<MAX_PROC; i++)
-		tabla_procs[i].estado=NO_USADA;
+	for (i=0; i<TAM_HASH_PIDS; i++)
+		hash_pids[i]=NULL;
 }
 
 /*
- * Funci�n que busca una entrada libre en la tabla de procesos
+ * Funcion que reserva un nuevo bloque de BCPs y los deja libres
  */
-static int buscar_BCP_libre(){
+static int ampliar_tabla_proc(){
+	BCP *bloque;
 	int i;
 
-	for (i=0; i<MAX_PROC; i++)
-		if (tabla_procs[i].estado==NO_USADA)
-			return i;
-	return -1;
+	if (num_bloques_procs==MAX_PROC/BCPS_POR_BLOQUE)
+		return -1;
+
+	bloque=calloc(BCPS_POR_BLOQUE, sizeof(BCP));
+	if (bloque==NULL)
+		return -1;
+
+	for (i=BCPS_POR_BLOQUE-1; i>=0; i--) {
+		bloque[i].estado=NO_USADA;
+		bloque[i].siguiente=BCPs_libres;
+		BCPs_libres=&bloque[i];
+	}
+	bloques_procs[num_bloques_procs++]=bloque;
+	return 0;
+}
+
+/*
+ * Funci�n que busca una entrada libre en la tabla de procesos.
+ * Tiempo constante salvo cuando hay que ampliar la tabla
+ */
+static BCP *buscar_BCP_libre(){
+	BCP *p;
+
+	if ((BCPs_libres==NULL) && (ampliar_tabla_proc()<0))
+		return NULL;
+
+	p=BCPs_libres;
+	BCPs_libres=p->siguiente;
+	return p;
+}
+
+/*
+ * Funcion que indica si buscar_BCP_libre encontraria una entrada
+ */
+static int hay_BCP_libre(){
+	return (BCPs_libres!=NULL) || (num_bloques_procs<MAX_PROC/BCPS_POR_BLOQUE);
+}
+
+/*
+ * Funcion que devuelve a la lista de libres un BCP sin pid
+ */
+static void devolver_BCP(BCP *p){
+	p->estado=NO_USADA;
+	p->siguiente=BCPs_libres;
+	BCPs_libres=p;
+}
+
+/*
+ * Funcion que asigna un pid nuevo a un BCP y lo anota en la tabla hash.
+ * Los pids nunca se reutilizan
+ */
+static void registrar_BCP(BCP *p){
+	int h;
+
+	p->id=siguiente_pid++;
+	h=p->id%TAM_HASH_PIDS;
+	p->siguiente_hash=hash_pids[h];
+	hash_pids[h]=p;
+	num_procesos++;
+}
+
+/*
+ * Funcion que libera el BCP de un proceso que termina
+ */
+static void liberar_BCP(BCP *p){
+	BCP **paux=&hash_pids[p->id%TAM_HASH_PIDS];
+
+	while (*paux!=p)
+		paux=&(*paux)->siguiente_hash;
+	*paux=p->siguiente_hash;
+
+	num_procesos--;
+	devolver_BCP(p);
+}
+
+/*
+ * Funcion que devuelve el BCP del proceso con ese pid o NULL si no existe
+ */
+static BCP *buscar_proceso(int pid){
+	BCP *p;
+
+	if (pid<0)
+		return NULL;
+
+	for (p=hash_pids[pid%TAM_HASH_PIDS]; p!=NULL; p=p->siguiente_hash)
+		if (p->id==pid)
+			return p;
+	return NULL;
+}
+
+/*
+ * Funcion que cuenta las entradas ocupadas de la tabla de procesos
+ */
+static int procesos_vivos(){
+	return num_procesos;
 }
 
 /*
  *
  * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
+ *	insertar_ultimo insertar_primero eliminar_primero eliminar_elem
  *
  * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
  */
@@ -65,6 +170,30 @@ static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
 	proc->siguiente=NULL;
 }
 
+/*
+ * Anade al final de la lista todos los BCPs de otra, que queda vacia.
+ */
+static void insertar_lista(lista_BCPs *lista, lista_BCPs *otra){
+	if (otra->primero==NULL)
+		return;
+	if (lista->primero==NULL)
+		lista->primero= otra->primero;
+	else
+		lista->ultimo->siguiente=otra->primero;
+	lista->ultimo= otra->ultimo;
+	otra->primero= otra->ultimo= NULL;
+}
+
+/*
+ * Inserta un BCP al principio de la lista.
+ */
+static void insertar_primero(lista_BCPs *lista, BCP * proc){
+	proc->siguiente=lista->primero;
+	lista->primero=proc;
+	if (lista->ultimo==NULL)
+		lista->ultimo=proc;
+}
+
 /*
  * Elimina el primer BCP de la lista.
  */
@@ -112,6 +241,8 @@ static void espera_int(){
 	nivel=fijar_nivel_int(NIVEL_1);
 	halt();
 	fijar_nivel_int(nivel);
+
+	int_disco(); /* el disco despierta a halt al terminar una operacion */
 }
 
 /*
@@ -125,6 +256,8 @@ static BCP *planificador()
 	Proceso_Expulsar = NULL;
 	while (lista_listos.primero == NULL)
 		espera_int(); /* No hay nada que hacer */
+	proteger_regiones(lista_listos.primero);
+	restaurar_pila(lista_listos.primero);
 	return lista_listos.primero;
 }
 
@@ -138,19 +271,120 @@ static void roundRobin()
 	}
 }
 
+/*
+ * Bloquea el proceso actual en la lista indicada y cede la UCP al
+ * siguiente proceso listo. Retorna cuando alguien lo desbloquea.
+ */
+static void bloquear_proceso(lista_BCPs *lista){
+	BCP * p_proc_bloq;
+	int nivel_int;
+
+	nivel_int=fijar_nivel_int(NIVEL_3);
+
+	p_proc_bloq=p_proc_actual;
+	p_proc_bloq->estado=BLOQUEADO;
+	p_proc_bloq->tick_bloqueo=num_ticks;
+	encolar_reclamo(p_proc_bloq);
+	eliminar_primero(&lista_listos);
+	insertar_ultimo(lista, p_proc_bloq);
+
+	p_proc_actual=planificador();
+	cambio_contexto(&(p_proc_bloq->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	fijar_nivel_int(nivel_int);
+}
+
+/*
+ * Pasa a listo el primer proceso de la lista indicada. Devuelve el
+ * proceso desbloqueado o NULL si la lista estaba vacia.
+ */
+static BCP *desbloquear_primero(lista_BCPs *lista){
+	BCP * proc;
+	int nivel_int;
+
+	nivel_int=fijar_nivel_int(NIVEL_3);
+
+	proc=lista->primero;
+	if (proc!=NULL) {
+		proc->estado=LISTO;
+		eliminar_primero(lista);
+		insertar_ultimo(&lista_listos, proc);
+	}
+
+	fijar_nivel_int(nivel_int);
+	return proc;
+}
+
+/*
+ * Pasa a listos, en una sola operacion, todos los procesos de la lista
+ * indicada. Devuelve cuantos procesos se han desbloqueado.
+ */
+static int desbloquear_todos(lista_BCPs *lista){
+	BCP * proc;
+	int n=0;
+	int nivel_int;
+
+	nivel_int=fijar_nivel_int(NIVEL_3);
+
+	if (lista->primero!=NULL) {
+		for (proc=lista->primero; proc!=NULL; proc=proc->siguiente) {
+			proc->estado=LISTO;
+			n++;
+		}
+
+		/* se engancha la lista entera al final de la de listos */
+		if (lista_listos.primero==NULL)
+			lista_listos.primero=lista->primero;
+		else
+			lista_listos.ultimo->siguiente=lista->primero;
+		lista_listos.ultimo=lista->ultimo;
+
+		lista->primero=NULL;
+		lista->ultimo=NULL;
+	}
+
+	fijar_nivel_int(nivel_int);
+	return n;
+}
+
 /*
  *
  * Funcion auxiliar que termina proceso actual liberando sus recursos.
  * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ * El estado de salida queda para el padre
  *
  */
-static void liberar_proceso(){
+static void liberar_proceso(int estado){
 	BCP * p_proc_anterior;
+	int ultimo_hilo;
+
+	/* lo compartido por los hilos se libera con el ultimo */
+	ultimo_hilo = salir_del_grupo(estado);
+	dejar_zombi(estado, ultimo_hilo); /* el proceso acaba con su ultimo hilo */
+	if (ultimo_hilo) {
+		cerrar_descriptores(); /* cierre implicito de mutex, semaforos... */
+		liberar_grupo();
+	}
+	cancelar_mensajes();
+	cancelar_regiones();
+	liberar_zombis(); /* hijos terminados que ya nadie esperara */
+	anotar_uso_pila(p_proc_actual);
+	quitar_alarma(p_proc_actual);
+
+	/* al liberar la imagen del ultimo proceso se apaga el sistema */
+	if (procesos_vivos()==1) {
+		volcar_estadisticas();
+		volcar_disco(); /* bloques pendientes de la cache */
+	}
 
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
+	/* liberar mapa (con el ultimo proceso, todos los de la cache) */
+	if (ultimo_hilo)
+		soltar_imagen(p_proc_actual, procesos_vivos()==1);
 
 	p_proc_actual->estado=TERMINADO;
 	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	liberar_BCP(p_proc_actual); /* BCP libre; la pila se libera despues */
+	desbloquear_primero(&lista_espera_BCP); /* alguien esperaba una entrada */
 
 	/* Realizar cambio de contexto */
 	p_proc_anterior=p_proc_actual;
@@ -159,7 +393,9 @@ static void liberar_proceso(){
 	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
 			p_proc_anterior->id, p_proc_actual->id);
 
-	liberar_pila(p_proc_anterior->pila);
+	devolver_pila(p_proc_anterior->pila, p_proc_anterior->tam_pila);
+	if (p_proc_anterior->pila_avisos != NULL)
+		liberar_pila(p_proc_anterior->pila_avisos);
 	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
         return; /* no deber�a llegar aqui */
 }
@@ -185,7 +421,7 @@ static void exc_arit(){
 
 
 	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	liberar_proceso(-1);
 
         return; /* no deber�a llegar aqui */
 }
@@ -195,12 +431,14 @@ static void exc_arit(){
  */
 static void exc_mem(){
 
-	if (!viene_de_modo_usuario())
+	//Un fallo al acceder a un parametro de usuario no es culpa del kernel
+	if (!viene_de_modo_usuario() && !acceso_parametro)
 		panico("excepcion de memoria cuando estaba dentro del kernel");
+	acceso_parametro=0;
 
 
 	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	liberar_proceso(-1);
 
         return; /* no deber�a llegar aqui */
 }
@@ -214,6 +452,16 @@ static void int_terminal(){
 	car = leer_puerto(DIR_TERMINAL);
 	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
 
+	//Si el buffer esta lleno el caracter se descarta
+	if (num_car_terminal == TAM_BUF_TERM)
+		return;
+
+	buffer_terminal[(primer_car_terminal + num_car_terminal) % TAM_BUF_TERM] = car;
+	num_car_terminal++;
+
+	desbloquear_primero(&lista_bloq_terminal);
+	comprobar_esperas_multiples(0);
+
         return;
 }
 
@@ -225,11 +473,49 @@ static void int_reloj(){
 	//printk("-> TRATANDO INT. DE RELOJ\n");
 	
 	
+	///////////
+	//Tiempos//
+	///////////
+	
+	contabilizarTiempos();
+	
+	
 	//////////
 	//Dormir//
 	//////////
 	
 	cuentaAtrasBloqueados();
+	cuentaAtrasAlarmas();
+	
+	
+	/////////
+	//Disco//
+	/////////
+	
+	int_disco();
+	cuentaAtrasVolcado();
+	
+	
+	/////////
+	//Pilas//
+	/////////
+	
+	cuentaAtrasPilas();
+	cuentaAtrasReclamo();
+	
+	
+	///////////////////
+	//Espera multiple//
+	///////////////////
+	
+	comprobar_esperas_multiples(1);
+	
+	
+	////////////////////////
+	//Creacion de procesos//
+	////////////////////////
+	
+	cuentaAtrasEsperaBCP();
 	
 	
 	///////////////
@@ -253,6 +539,9 @@ static void tratar_llamsis(){
 	else
 		res=-1;		/* servicio no existente */
 	escribir_registro(0,res);
+
+	/* vuelta a modo usuario: se ejecutan los avisos pendientes */
+	entregar_avisos();
 	return;
 }
 
@@ -277,46 +566,111 @@ static void int_sw()
 	}
 	fijar_nivel_int(interrupcion);
 
+	if (viene_de_modo_usuario())
+		entregar_avisos();
+
 	return;
 }
 
+/*
+ *
+ * Funcion auxiliar que rellena el BCP de un proceso nuevo con su imagen ya
+ * obtenida. Usada por crear_tarea, sis_crear_procesos y sis_crear_hilo:
+ * en este caso hilo_de es el proceso cuyo grupo de hilos se une y con el
+ * que comparte imagen y descriptores (NULL en un proceso). El proceso
+ * queda listo pero sin insertar en ninguna lista
+ *
+ */
+static void iniciar_tarea(BCP *p_proc, char *prog, void *imagen, void *pc_inicial, int tam_pila, BCP *hilo_de){
+	p_proc->info_mem = imagen;
+	p_proc->pila = obtener_pila(tam_pila);
+	p_proc->tam_pila = tam_pila;
+	p_proc->reclamada_desde = p_proc->reclamada_hasta = NULL;
+	p_proc->en_cola_reclamo = 0;
+	if (hilo_de == NULL)
+		asignar_uso_pila(p_proc, prog);
+	else
+		unir_uso_pila(p_proc, hilo_de->uso_pila);
+	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, tam_pila,
+		pc_inicial,
+		&(p_proc->contexto_regs));
+	registrar_BCP(p_proc);
+	p_proc->estado = LISTO;
+
+	/* init no tiene padre, ni los hilos: nadie recoge su estado */
+	p_proc->padre = ((p_proc_actual != NULL) && (hilo_de == NULL)) ? p_proc_actual->id : -1;
+	if (p_proc->padre != -1)
+		p_proc_actual->hijos_vivos++;
+	p_proc->hijos_vivos = 0;
+	p_proc->zombis = NULL;
+	p_proc->esperando_hijo = 0;
+
+	if (hilo_de != NULL) {
+
+		p_proc->grupo = hilo_de->grupo;
+		p_proc->grupo->hilos++;
+		p_proc->descriptores = p_proc->grupo->descriptores;
+		p_proc->n_descriptores = &p_proc->grupo->n_descriptores;
+	}
+	else {
+
+		/* sin descriptores abiertos, salvo las tuberias heredadas */
+		p_proc->grupo = NULL;
+		p_proc->descriptores = p_proc->descriptores_propios;
+		p_proc->n_descriptores = &p_proc->n_descriptores_propio;
+		for (int i = 0; i < NUM_DESC_PROC; i++)
+			p_proc->descriptores[i].tipo = DESC_LIBRE;
+		heredar_descriptores(p_proc);
+		p_proc->n_descriptores_propio = 0;
+	}
+
+	/* los cerrojos se tienen por hilo aunque el descriptor sea comun */
+	memset(p_proc->modo_cerrojos, 0, sizeof(p_proc->modo_cerrojos));
+
+	/* ni tiempo consumido */
+	p_proc->n_eventos = 0;
+	p_proc->ipc_estado = IPC_NADA;
+	p_proc->emisores.primero = p_proc->emisores.ultimo = NULL;
+	p_proc->avisos_pendientes = 0;
+	p_proc->entrada_avisos = NULL;
+	p_proc->pila_avisos = NULL;
+	p_proc->en_manejador = 0;
+	p_proc->ticks_alarma = 0;
+	p_proc->ticks_usuario = 0;
+	p_proc->ticks_sistema = 0;
+}
+
 /*
  *
  * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
+ * Usada por llamada crear_proceso. Devuelve el pid del proceso o -1.
  *
  */
-static int crear_tarea(char *prog){
+static int crear_tarea(char *prog, int tam_pila){
 	void * imagen, *pc_inicial;
 	int error=0;
-	int proc;
 	BCP *p_proc;
 
-proc = buscar_BCP_libre();
-if (proc == -1)
+p_proc = buscar_BCP_libre();
+if (p_proc == NULL)
 return -1;	/* no hay entrada libre */
 
 /* A rellenar el BCP ... */
-p_proc = &(tabla_procs[proc]);
 
-/* crea la imagen de memoria leyendo ejecutable */
-imagen = crear_imagen(prog, &pc_inicial);
+/* crea la imagen de memoria leyendo ejecutable, salvo que este en cache */
+imagen = obtener_imagen(p_proc, prog, &pc_inicial);
 if (imagen)
 {
-	p_proc->info_mem = imagen;
-	p_proc->pila = crear_pila(TAM_PILA);
-	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-		pc_inicial,
-		&(p_proc->contexto_regs));
-	p_proc->id = proc;
-	p_proc->estado = LISTO;
+	iniciar_tarea(p_proc, prog, imagen, pc_inicial, tam_pila, NULL);
 
 	/* lo inserta al final de cola de listos */
 	insertar_ultimo(&lista_listos, p_proc);
-	error = 0;
+	error = p_proc->id;
+}
+else {
+	devolver_BCP(p_proc);
+	error = -1; /* fallo al crear imagen */
 }
-else
-error = -1; /* fallo al crear imagen */
 
 return error;
 }
@@ -338,10 +692,160 @@ int sis_crear_proceso() {
 
 	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
 	prog = (char*)leer_registro(1);
-	res = crear_tarea(prog);
+	res = crear_tarea(prog, TAM_PILA);
 	return res;
 }
 
+/*
+ * Tratamiento de llamada al sistema crear_proceso_con_pila. Como
+ * crear_proceso pero con una pila del tamano pedido (0 por defecto),
+ * redondeado a paginas
+ */
+int sis_crear_proceso_con_pila() {
+	char* prog;
+	int tam;
+	long pagina = sysconf(_SC_PAGESIZE);
+
+	printk("-> PROC %d: CREAR PROCESO CON PILA\n", p_proc_actual->id);
+	prog = (char*)leer_registro(1);
+	tam = (int)leer_registro(2);
+
+	if (tam == 0)
+		tam = TAM_PILA;
+	if ((tam < TAM_PILA_MIN) || (tam > TAM_PILA_MAX)) {
+
+		printk("Tamano de pila no valido (%d-%d). ERROR\n", TAM_PILA_MIN, TAM_PILA_MAX);
+		return -1;
+	}
+
+	return crear_tarea(prog, (tam + pagina - 1) / pagina * pagina);
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_procesos. Crea hasta n procesos
+ * del mismo programa en una sola llamada: la imagen se busca una vez y
+ * los procesos se anaden juntos a la cola de listos. Deja sus pids en el
+ * vector del usuario y devuelve cuantos ha creado (-1 si ninguno)
+ */
+int sis_crear_procesos() {
+	char* prog;
+	int n, *pids, i;
+	int creados[MAX_CREAR_PROCESOS];
+	lista_BCPs nuevos = {NULL, NULL};
+	BCP *p_proc, *modelo = NULL;
+	void *imagen, *pc_inicial;
+	int nivel;
+
+	prog = (char*)leer_registro(1);
+	n = (int)leer_registro(2);
+	pids = (int*)leer_registro(3);
+	printk("-> PROC %d: CREAR %d PROCESOS\n", p_proc_actual->id, n);
+
+	if ((n < 1) || (n > MAX_CREAR_PROCESOS)) {
+
+		printk("Numero de procesos no valido (1-%d). ERROR\n", MAX_CREAR_PROCESOS);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++) {
+
+		if ((p_proc = buscar_BCP_libre()) == NULL)
+			break;	/* no hay mas entradas libres */
+
+		imagen = (modelo != NULL) ? compartir_imagen(p_proc, modelo, &pc_inicial) : NULL;
+		if (imagen == NULL)
+			imagen = obtener_imagen(p_proc, prog, &pc_inicial);
+		if (imagen == NULL) {
+
+			devolver_BCP(p_proc);
+			break;
+		}
+
+		iniciar_tarea(p_proc, prog, imagen, pc_inicial, TAM_PILA, NULL);
+		insertar_ultimo(&nuevos, p_proc);
+		creados[i] = p_proc->id;
+		modelo = p_proc;
+	}
+
+	nivel = fijar_nivel_int(NIVEL_3);
+	insertar_lista(&lista_listos, &nuevos);
+	fijar_nivel_int(nivel);
+
+	if (i == 0)
+		return -1;
+
+	copiar_parametro(pids, creados, i * sizeof(int));
+	return i;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso_esperando. Como
+ * crear_proceso pero, si la tabla de procesos esta llena, se bloquea
+ * hasta que termine algun proceso o venza el plazo (en ms, negativo sin
+ * limite, 0 no espera). Se despierta a un proceso por cada entrada que
+ * se libera; si otro se la quita vuelve a esperar lo que le quede
+ */
+int sis_crear_proceso_esperando() {
+	char* prog;
+	int timeout;
+	int nivel;
+
+	printk("-> PROC %d: CREAR PROCESO ESPERANDO\n", p_proc_actual->id);
+	prog = (char*)leer_registro(1);
+	timeout = (int)leer_registro(2);
+
+	nivel = fijar_nivel_int(NIVEL_3);
+	p_proc_actual->ticks_timeout = (timeout < 0) ? -1 : (timeout * TICK + 999) / 1000;
+
+	while (!hay_BCP_libre()) {
+
+		if (p_proc_actual->ticks_timeout == 0) {
+
+			fijar_nivel_int(nivel);
+			printk("No se ha liberado ninguna entrada de la tabla de procesos. ERROR\n");
+			return -1;
+		}
+		bloquear_proceso(&lista_espera_BCP);
+	}
+
+	fijar_nivel_int(nivel);
+	int pid = crear_tarea(prog, TAM_PILA);
+
+	//Si no ha ocupado la entrada (p.ej. el programa no existe) el aviso
+	//pasa al siguiente que espera
+	nivel = fijar_nivel_int(NIVEL_3);
+	if (hay_BCP_libre())
+		desbloquear_primero(&lista_espera_BCP);
+	fijar_nivel_int(nivel);
+
+	return pid;
+}
+
+/*
+ * Descuenta el plazo de los procesos que esperan una entrada de la tabla
+ * de procesos y despierta a los que lo agotan. Llamada desde int_reloj
+ */
+void cuentaAtrasEsperaBCP(){
+	int nivel = fijar_nivel_int(NIVEL_3);
+	BCPptr aux = lista_espera_BCP.primero;
+
+	while (aux != NULL) {
+
+		BCPptr siguiente = aux->siguiente;
+
+		if ((aux->ticks_timeout > 0) && (--aux->ticks_timeout == 0)) {
+
+			aux->estado = LISTO;
+			eliminar_elem(&lista_espera_BCP, aux);
+			insertar_ultimo(&lista_listos, aux);
+		}
+
+		aux = siguiente;
+	}
+
+	fijar_nivel_int(nivel);
+}
+
 /*
  * Tratamiento de llamada al sistema escribir. Llama simplemente a la
  * funcion de apoyo escribir_ker
@@ -364,30 +868,11 @@ int sis_escribir()
  */
 int sis_terminar_proceso() {
 
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
-	
-	/////////
-	//MUTEX//
-	/////////
-	if (p_proc_actual->n_descriptores > 0) {
-
-		printk("Cerrar mutex que ha abierto el proceso\n");
-
-		for (int i = 0; i < NUM_MUT_PROC; i++) {
-			
+	int estado = (int)leer_registro(1);
 
-			unsigned int des = p_proc_actual->descriptores[i];
-			if (des != 0){
-				
-				
-				cerrar_mutex(i);
-
-			}
-		}
-		printk("Se ha terminado de cerrar los mutex\n");
-	}
+	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
 	
-	liberar_proceso();
+	liberar_proceso(estado);
 
 	return 0; /* no deber�a llegar aqui */
 }
@@ -415,12 +900,14 @@ int dormir(unsigned int segundos){
 
 	//actualizamos la estructura de datos BCPptr
 	actual->estado = BLOQUEADO;
+	actual->tick_bloqueo = num_ticks;
+	encolar_reclamo(actual);
 	actual->segundosDormir = segundosRegistros * TICK;
 	
 
 	//cambiamos de lista el proceso actual
 	eliminar_elem(&lista_listos, actual);
-	insertar_ultimo(&lista_bloq_mutex, actual);
+	insertar_ultimo(&lista_dormidos, actual);
 
 	//el planificador devuelve el proceso a ejecutar siguiente en la cola
 	p_proc_actual = planificador();
@@ -439,7 +926,7 @@ void cuentaAtrasBloqueados(){
 	//printk("CUENTA ATRAS BLOQUEADOS COMIENZA\n");
 	//recorro la lista y actualizo los tiempos
 	
-	BCPptr aux = lista_bloq_mutex.primero;
+	BCPptr aux = lista_dormidos.primero;
 	int nivelInterrupcion = fijar_nivel_int(NIVEL_3);
 	
 	
@@ -457,7 +944,7 @@ void cuentaAtrasBloqueados(){
 		if(aux->segundosDormir <=0){
 			//si ha terminado lo cambio de lista
 			aux->estado = LISTO;
-			eliminar_elem(&lista_bloq_mutex, aux);
+			eliminar_elem(&lista_dormidos, aux);
 			insertar_ultimo(&lista_listos, aux);
 		}
 		
@@ -470,18 +957,55 @@ void cuentaAtrasBloqueados(){
 	return;
 }
 
-///////////
-// MUTEX //
-///////////
+/////////////
+// TIEMPOS //
+/////////////
 
-//////// FUNCIONES AUXILIARES //////////
+//Llamada desde la interrupcion de reloj: imputa el tick al proceso en ejecucion
+void contabilizarTiempos(){
+
+	num_ticks++;
+
+	//Si no hay ningun proceso listo el procesador esta ocioso
+	if (p_proc_actual == NULL || p_proc_actual->estado != LISTO)
+		return;
+
+	if (viene_de_modo_usuario())
+		p_proc_actual->ticks_usuario++;
+	else
+		p_proc_actual->ticks_sistema++;
+}
+
+int sis_tiempos_proceso(){
+
+	struct tiempos_ejec *t_ejec = (struct tiempos_ejec *)leer_registro(1);
+
+	if (t_ejec != NULL) {
+
+		//Si la direccion no es valida exc_mem abortara el proceso
+		int nivel_int = fijar_nivel_int(NIVEL_3);
+		acceso_parametro = 1;
+		t_ejec->usuario = p_proc_actual->ticks_usuario;
+		t_ejec->sistema = p_proc_actual->ticks_sistema;
+		acceso_parametro = 0;
+		fijar_nivel_int(nivel_int);
+	}
+
+	return num_ticks;
+}
+
+/////////////////
+// DESCRIPTORES //
+/////////////////
+
+//Devuelve la primera entrada libre del array de descriptores del proceso
+//actual o -1 si estan todas ocupadas
 int descriptor_libre() {
 
-	for (int i = 0; i < NUM_MUT_PROC; i++) {
+	for (int i = 0; i < NUM_DESC_PROC; i++) {
 		
-		if (p_proc_actual->descriptores[i] == 0){
+		if (p_proc_actual->descriptores[i].tipo == DESC_LIBRE){
 		
-			p_proc_actual->descriptores[i]++;
 			return i;
 		}
 	}
@@ -489,27 +1013,102 @@ int descriptor_libre() {
 	return -1;
 }
 
-int nombres_iguales(char* nombre) {
-	for (int i = 0; i < mutex_creados; i++) {
+//Asocia un descriptor libre del proceso actual a un objeto
+static int asignar_descriptor(int tipo, int id) {
 
-		//Si el mutex existe
-		if (array_mutex[i].abierto != 0) {
+	int nuevo_des = descriptor_libre();
 
-			//Comprobamos si las cadenas son iguales
-			if ((strcmp(nombre, array_mutex[i].nombre)) == 0) {
+	if (nuevo_des == -1) {
 
-				//Da error si hay dos mutex con el mismo nombre
-				return -1;
-			}
-		}
+		printk("El proceso no tiene descriptores libres. ERROR\n");
+		return -1;
 	}
-	return 0; //Si no encuentra nombre igual
+
+	p_proc_actual->descriptores[nuevo_des].tipo = tipo;
+	p_proc_actual->descriptores[nuevo_des].id = id;
+	p_proc_actual->descriptores[nuevo_des].usos = 0;
+	return nuevo_des;
 }
 
-int descriptor_mutex() {
+//Devuelve la posicion en su array global del objeto asociado a un
+//descriptor del proceso actual o -1 si el descriptor no es valido o
+//corresponde a un objeto de otro tipo
+int objeto_de_descriptor(unsigned int descriptor, int tipo) {
 
-	int aux = -1;
-	int i = 0;
+	if (descriptor >= NUM_DESC_PROC)
+		return -1;
+
+	if (p_proc_actual->descriptores[descriptor].tipo != tipo)
+		return -1;
+
+	return p_proc_actual->descriptores[descriptor].id;
+}
+
+//Cierra un descriptor del proceso actual sea cual sea su tipo
+int cerrar_descriptor(unsigned int descriptor) {
+
+	if (descriptor >= NUM_DESC_PROC)
+		return -1;
+
+	switch (p_proc_actual->descriptores[descriptor].tipo) {
+		case DESC_MUTEX:
+			return cerrar_descriptor_mutex(descriptor);
+		case DESC_SEMAFORO:
+			return cerrar_descriptor_sem(descriptor);
+		case DESC_CONDICION:
+			return cerrar_descriptor_cond(descriptor);
+		case DESC_CERROJO:
+			return cerrar_descriptor_cerrojo(descriptor);
+		case DESC_BARRERA:
+			return cerrar_descriptor_barrera(descriptor);
+		case DESC_TUBERIA_LECTURA:
+		case DESC_TUBERIA_ESCRITURA:
+			return cerrar_descriptor_tuberia(descriptor);
+		case DESC_SEGMENTO:
+			return cerrar_descriptor_segmento(descriptor);
+		case DESC_FICHERO:
+			return cerrar_descriptor_fichero(descriptor);
+		case DESC_REGION:
+			return cerrar_descriptor_region(descriptor);
+	}
+	return -1;
+}
+
+//Cierre implicito de todos los descriptores al terminar el proceso actual
+void cerrar_descriptores() {
+
+	for (int i = 0; i < NUM_DESC_PROC; i++)
+		if (p_proc_actual->descriptores[i].tipo != DESC_LIBRE)
+			cerrar_descriptor(i);
+}
+
+///////////
+// MUTEX //
+///////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+int nombres_iguales(char* nombre) {
+	for (int i = 0; i < NUM_MUT; i++) {
+
+		//Si el mutex existe
+		if (array_mutex[i].abierto != 0) {
+
+			//Comprobamos si las cadenas son iguales
+			if ((strcmp(nombre, array_mutex[i].nombre)) == 0) {
+
+				//Da error si hay dos mutex con el mismo nombre
+				return -1;
+			}
+		}
+	}
+	return 0; //Si no encuentra nombre igual
+}
+
+int descriptor_mutex() {
+
+	int aux = -1;
+	int i = 0;
 
 	while ((aux == -1) && (i < NUM_MUT)) {
 
@@ -524,235 +1123,281 @@ int descriptor_mutex() {
 	return aux;
 }
 
-////////// FUNCIONES PEDIDAS ////////////
+//Devuelve la posicion en array_mutex del mutex asociado a un descriptor
+//del proceso actual o -1 si el descriptor no es valido
+int mutex_de_descriptor(unsigned int descriptor) {
 
-int lock(unsigned int mutexid) {
+	return objeto_de_descriptor(descriptor, DESC_MUTEX);
+}
 
-	printk("SECCI�N LOCK\n");
-	printk("Se procede a bloquear el mutex\n");
+//Deja libre un mutex sin anotar su retencion. Si el mutex es de tipo
+//TRASPASO, el primer proceso en espera pasa a ser el propietario sin
+//tener que volver a competir por el; si no, solo se le despierta
+static void ceder_mutex(mutex *m) {
 
-	//Recibe el descriptor
-	unsigned int id = (unsigned int) leer_registro(1); 
-	
-	int encontrado= -1;
-	for(int i = 0;i < NUM_MUT_PROC;i++){
-	
-		if(p_proc_actual->descriptores[i] == id) encontrado = 0;
+	BCP* proc_esperando;
+
+	m->locked = 0;
+	m->propietario = -1;
+
+	proc_esperando = desbloquear_primero(&m->lista_proc_esperando_lock);
+	if (proc_esperando == NULL) {
+
+		comprobar_esperas_multiples(0);
+		return;
 	}
-	
-	if (encontrado == -1) {
 
-		printk("El descriptor del mutex no existe. ERROR\n");
-		return -1;
+	m->n_procesos_esperando--;
+	printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
+
+	if (m->traspaso) {
+
+		m->locked = 1;
+		m->propietario = proc_esperando->id;
 	}
+}
 
-	//Hacemos un bucle por si el proceso se queda bloqueado le esperamos
-	int proceso_block = 0;
+//Libera un mutex cuyo contador de lock ha llegado a 0
+static void liberar_mutex(mutex *m) {
 
-	while (proceso_block == 0) {
+	unsigned int retencion = num_ticks - m->tick_adquisicion;
 
-		//Si el mutex no se ha bloqueado a�n lo bloqueamos 
-		if (array_mutex[id].locked == 0) {
+	m->estadisticas.ticks_retencion += retencion;
+	if (retencion > m->estadisticas.max_ticks_retencion)
+		m->estadisticas.max_ticks_retencion = retencion;
 
-			array_mutex[id].locked++;
-			proceso_block = 1;
-			
-			printk("Lock realizado correctamente -> id del mutex = %d\n\n", id);
-			return 0;
-		}
-		
-		//Comprobamos si el mutex esta ya bloqueado y si es recursivo, en ese caso, se podria volver a bloquear
-		if ((array_mutex[id].locked > 0) && (array_mutex[id].tipo == 1)) {
+	ceder_mutex(m);
+}
 
+//Actualiza las estadisticas de un mutex que acaba de obtener el proceso
+//actual tras intentarlo desde el tick inicio
+static void anotar_adquisicion(mutex *m, unsigned int inicio, int esperado) {
 
-			printk("Id del propietario del mutex = %d. Id del proceso actual: %d\n", array_mutex[id].propietario, p_proc_actual->id);
+	m->tick_adquisicion = num_ticks;
+	m->estadisticas.adquisiciones++;
 
-			//Comprobamos si ha sido bloqueado por el proceso actual
-			if (array_mutex[id].propietario == p_proc_actual->id) {
+	if (esperado) {
 
-				
-				//Si el proceso actual es el propiertario del mutex entonces lo volvemos a bloquear
-				array_mutex[id].locked++;
-				proceso_block = 1;
-			}	
-			//Si no es el propietario se bloquea el proceso actual
-			else {
+		unsigned int espera = num_ticks - inicio;
 
-				printk("Este mutex ya esta bloqueado por otro proceso, se procede a bloquear el proceso actual\n");
+		m->estadisticas.adquisiciones_con_espera++;
+		m->estadisticas.ticks_espera += espera;
+		if (espera > m->estadisticas.max_ticks_espera)
+			m->estadisticas.max_ticks_espera = espera;
+	}
+}
 
-				int nivel_int = fijar_nivel_int(NIVEL_3);
+//Quita un lock del proceso actual sobre el mutex y lo libera si el
+//contador llega a 0. Usada por unlock y unlock_varios
+static int soltar_mutex(int id) {
 
-				//Cambiamos el estado del proceso a bloqueado
-				p_proc_actual->estado = BLOQUEADO;
+	mutex *m = &array_mutex[id];
 
-				//Lo eliminamos de la lista de procesos listos y lo ponemos en la lista de procesos bloqueados
-				eliminar_primero(&lista_listos);
-				insertar_ultimo(&array_mutex[id].lista_proc_esperando_lock, p_proc_actual);
-				array_mutex[id].n_procesos_esperando++;
+	//Comprobamos que el mutex este bloqueado
+	if (m->locked == 0) {
 
-				//Conseguimos el nuevo proceso actual 
-				BCP* p_proc_bloq = p_proc_actual;
-				p_proc_actual = planificador();
+		//Si no esta bloqueado da error
+		printk("El mutex no se ha bloqueado, por tanto, no se puede desbloquear. ERROR\n");
+		return -1;
+	}
 
-				//Cambiamos el contexto
-				cambio_contexto(&(p_proc_bloq->contexto_regs), &(p_proc_actual->contexto_regs));
-				printk("Contexto cambiado del proceso: %d al proceso: %d\n", p_proc_bloq->id, p_proc_actual->id);
+	//Si el proceso actual no es el que lo bloque� no puede desbloquearlo
+	if (m->propietario != p_proc_actual->id) {
 
-				//Recuperamos el nivel de interrupcion anterior
-				fijar_nivel_int(nivel_int);
-			}
-		}
+		printk("Este proceso no ha sido el bloqueante del mutex, por lo tanto, no puede desbloquearlo. ERROR\n");
+		return -1;
+	}
+
+	//Si es el due�o lo desbloquea. Si es recursivo puede seguir bloqueado
+	m->locked--;
+	if (m->locked == 0)
+		liberar_mutex(m);
 
-		//Comprobamos si el mutex esta bloqueado y es NO_RECURSIVO 
-		if ((array_mutex[id].locked > 0) && (array_mutex[id].tipo == 0)) {
+	return 0;
+}
 
-			//Comprobamos si ha sido bloqueado por el proceso actual
-			if (array_mutex[id].propietario == p_proc_actual->id) {
+//Copia del espacio del usuario una lista de n descriptores de mutex y la
+//traduce a posiciones de array_mutex. Falla si algun descriptor no es
+//valido o aparece repetido
+static int leer_lista_mutex(unsigned int *descs, int n, int *ids) {
 
-				printk("El mutex que se quiere bloquear no es recursivo y ya ha sido bloqueado por este proceso. ERROR\n");
-				return -1;
-			}
-			//Si el mutex ha sido bloqueado por un proceso que no es el actual
-			else {
+	int nivel;
+
+	if ((n <= 0) || (n > NUM_DESC_PROC)) {
 
-				printk("Este mutex ya esta bloqueado por otro proceso, se procede a bloquear el proceso actual\n");
+		printk("Numero de mutex no valido. ERROR\n");
+		return -1;
+	}
 
-				int nivel_int = fijar_nivel_int(NIVEL_3);
+	for (int i = 0; i < n; i++) {
 
-				//Cambiamos el estado del proceso a bloqueado
-				p_proc_actual->estado = BLOQUEADO;
+		nivel = fijar_nivel_int(NIVEL_3);
+		acceso_parametro = 1;
+		unsigned int des = descs[i];
+		acceso_parametro = 0;
+		fijar_nivel_int(nivel);
 
-				//Lo eliminamos de la lista de procesos listos y lo ponemos en la lista de procesos bloqueados
-				eliminar_primero(&lista_listos);
-				insertar_ultimo(&array_mutex[id].lista_proc_esperando_lock, p_proc_actual);
+		ids[i] = mutex_de_descriptor(des);
+		if (ids[i] < 0) {
 
-				//Conseguimos el nuevo proceso actual 
-				BCP* p_proc_bloq = p_proc_actual;
-				p_proc_actual = planificador();
+			printk("El descriptor del mutex no existe. ERROR\n");
+			return -1;
+		}
 
-				//Cambiamos el contexto
-				cambio_contexto(&(p_proc_bloq->contexto_regs), &(p_proc_actual->contexto_regs));
-				printk("Contexto cambiado del proceso: %d al proceso: %d\n", p_proc_bloq->id, p_proc_actual->id);
+		for (int j = 0; j < i; j++)
+			if (ids[j] == ids[i]) {
 
-				//Recuperamos el nivel de interrupcion anterior
-				fijar_nivel_int(nivel_int);
+				printk("Mutex repetido en la lista. ERROR\n");
+				return -1;
 			}
-		}
 	}
 
-	printk("Lock realizado correctamente -> id del mutex = %d\n\n", id);
 	return 0;
 }
 
-int unlock(unsigned int mutexid) {
+//Cierra un descriptor de mutex del proceso actual. Si el proceso era el
+//propietario del mutex lo libera y si era el ultimo descriptor abierto
+//elimina el mutex
+int cerrar_descriptor_mutex(unsigned int descriptor) {
 
-	printk("SECCI�N UNLOCK\n");
-	printk("Se procede a desbloquear el mutex\n");
+	int id = mutex_de_descriptor(descriptor);
 
-	//Recibe el descriptor
-	int descriptor_proceso = (unsigned int)leer_registro(1);
+	if (id < 0) {
 
-	//Guardamos el id del descriptor del mutex
-	int id_mutex = p_proc_actual->descriptores[descriptor_proceso];
+		printk("El descriptor buscado no se ha encontrado. ERROR \n");
+		return -1;
+	}
 
+	mutex *m = &array_mutex[id];
 
-	//No se puede usar un mutex si este no esta abierto asi que debemos comprobar que lo est�
-	if (array_mutex[descriptor_proceso].abierto == 0) {
+	//Si el mutex a cerrar esta bloqueado por este proceso, hay que liberarlo
+	if ((m->locked > 0) && (m->propietario == p_proc_actual->id)) {
 
-		printk("Este mutex no ha sido abierto a�n. ERROR\n");
-		return -1;
+		printk("Se procede a desbloquear el mutex\n");
+		liberar_mutex(m);
 	}
 
-	//Comprobamos que el mutex este bloqueado
-	if (array_mutex[descriptor_proceso].locked == 0) {
-		
-		//Si no esta bloqueado da error
-		printk("El mutex no se ha bloqueado, por tanto, no se puede desbloquear. ERROR\n");
-		return -1;
+	//Lo quitamos del array de descriptores del proceso
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	(*p_proc_actual->n_descriptores)--;
+	m->abierto--;
+
+	//Si ya no lo tiene abierto ningun proceso se elimina
+	if (m->abierto == 0) {
+
+		printk("El mutex %d ha sido eliminado\n", id);
+		mutex_creados--;
+
+		//Si hay algun proceso esperando porque se habian creado el maximo
+		//de mutex, hay que desbloquearlo
+		BCP* proc_esperando;
+		while ((proc_esperando = desbloquear_primero(&lista_bloq_mutex)) != NULL)
+			printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
 	}
-	//Si esta bloqueado entonces comprobamos 
-	else {
 
-		//Comprobamos si el mutex esta bloqueado y si es recursivo
-		if ((array_mutex[descriptor_proceso].locked > 0) && (array_mutex[descriptor_proceso].tipo == RECURSIVO)) {
+	printk("El mutex %d ha sido cerrado correctamente\n", id);
+	return 0;
+}
+
+////////// FUNCIONES PEDIDAS ////////////
+
+int lock(unsigned int mutexid) {
 
-			//Comprobamos si ha sido bloqueado por el proceso actual y si es as� lo desbloqueamos
-			if (array_mutex[descriptor_proceso].propietario == p_proc_actual->id) {
+	printk("SECCI�N LOCK\n");
+	printk("Se procede a bloquear el mutex\n");
 
-				//Si es el due�o lo desbloquea
-				array_mutex[descriptor_proceso].locked--;
+	//Recibe el descriptor
+	mutexid = (unsigned int) leer_registro(1);
 
-				//Hay que comprobar si el mutex sigue bloqueado
-				if (array_mutex[descriptor_proceso].locked == 0) {
+	int id = mutex_de_descriptor(mutexid);
+	if (id < 0) {
 
-					//Comprobamos si existen procesos bloqueados en este mutex y si es as� lo desbloqueamos
-					if (((array_mutex[descriptor_proceso].lista_proc_esperando_lock).primero) != NULL) {
+		printk("El descriptor del mutex no existe. ERROR\n");
+		return -1;
+	}
 
-						int nivel_int = fijar_nivel_int(NIVEL_3);
+	return adquirir_mutex(id);
+}
 
-						//Cogemos el proceso que esta esperando y lo ponemos a listo
-						BCP* proc_esperando = (array_mutex[descriptor_proceso].lista_proc_esperando_lock).primero;
-						proc_esperando->estado = LISTO;
+//Obtiene el mutex para el proceso actual bloqueandolo mientras lo tenga
+//otro proceso. Usada por lock y por esperar_cond
+int adquirir_mutex(int id) {
 
-						//Lo eliminamos de la lista de procesos esperando y lo ponemos en la lista de listos
-						eliminar_primero(&(array_mutex[descriptor_proceso].lista_proc_esperando_lock));
-						insertar_ultimo(&lista_listos, proc_esperando);
+	mutex *m = &array_mutex[id];
+	unsigned int inicio = num_ticks;
+	int esperado = 0;
 
-						//Recuperamos el nivel de interrupci�n anterior
-						fijar_nivel_int(nivel_int);
-						
-						printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
-					}
+	//Hacemos un bucle por si el proceso se queda bloqueado le esperamos
+	while (1) {
 
-					//Una vez desbloqueado lo eliminamos de propietario
-					array_mutex[descriptor_proceso].propietario = -1;
-				} 
-			}
-			//Si el proceso actual no es el que lo bloque� no puede desbloquearlo
-			else {
+		//Si el mutex no se ha bloqueado a�n lo bloqueamos
+		if (m->locked == 0) {
 
-				printk("Este proceso no ha sido el bloqeuante del mutex, por lo tanto, no puede desbloquearlo. ERROR\n");
-				return -1;
+			m->locked++;
+			m->propietario = p_proc_actual->id;
+			break;
+		}
+
+		//Comprobamos si ha sido bloqueado por el proceso actual
+		if (m->propietario == p_proc_actual->id) {
+
+			//Si es recursivo se podria volver a bloquear
+			if (m->tipo == RECURSIVO) {
+
+				m->locked++;
+				break;
 			}
+
+			printk("El mutex que se quiere bloquear no es recursivo y ya ha sido bloqueado por este proceso. ERROR\n");
+			return -1;
 		}
 
-		//Comprobamos si el mutex esta bloqueado y si no es recursivo
-		if ((array_mutex[descriptor_proceso].locked > 0) && (array_mutex[descriptor_proceso].tipo == NO_RECURSIVO)) {
+		//Si el mutex ha sido bloqueado por otro proceso se bloquea el proceso actual
+		printk("Este mutex ya esta bloqueado por otro proceso, se procede a bloquear el proceso actual\n");
 
-			//Comprobamos que el mutex haya sido bloqueado por el proceso actual
-			if (array_mutex[descriptor_proceso].propietario == p_proc_actual->id) {
+		m->n_procesos_esperando++;
+		if (m->n_procesos_esperando > m->estadisticas.max_esperando)
+			m->estadisticas.max_esperando = m->n_procesos_esperando;
 
-				//Si es el due�o lo desbloquea
-				array_mutex[descriptor_proceso].locked--;
+		esperado = 1;
+		bloquear_proceso(&m->lista_proc_esperando_lock);
 
-				//Si alg�n proceso esta esperando por el mutex lo desbloqueamos
-				if (((array_mutex[descriptor_proceso].lista_proc_esperando_lock).primero) != NULL) {
+		//En modo traspaso unlock ya nos ha hecho propietarios: no hay que
+		//volver a comprobar el estado del mutex
+		if (m->propietario == p_proc_actual->id)
+			break;
+	}
 
-					int nivel_int = fijar_nivel_int(NIVEL_3);
+	//Los lock recursivos no son una nueva adquisicion
+	if (m->locked == 1)
+		anotar_adquisicion(m, inicio, esperado);
 
-					//Cogemos el proceso que esta esperando y lo ponemos a listo
-					BCP* proc_esperando = (array_mutex[descriptor_proceso].lista_proc_esperando_lock).primero;
-					proc_esperando->estado = LISTO;
+	printk("Lock realizado correctamente -> id del mutex = %d\n\n", id);
+	return 0;
+}
 
-					//Lo eliminamos de la lista de procesos esperando y lo ponemos en la lista de listos
-					eliminar_primero(&(array_mutex[descriptor_proceso].lista_proc_esperando_lock));
-					insertar_ultimo(&lista_listos, proc_esperando);
+int unlock(unsigned int mutexid) {
 
-					//Recuperamos el nivel de interrupci�n anterior
-					fijar_nivel_int(nivel_int);
+	printk("SECCI�N UNLOCK\n");
+	printk("Se procede a desbloquear el mutex\n");
 
-					printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
-				}
-			}
-			else {
+	//Recibe el descriptor
+	mutexid = (unsigned int)leer_registro(1);
 
-				printk("Este proceso no ha sido el bloqueante del mutex, por lo tanto, no puede desbloquearlo. ERROR\n");
-				return -1;
-			}
-		}
+	//Guardamos el id del descriptor del mutex
+	int id = mutex_de_descriptor(mutexid);
+
+	//No se puede usar un mutex si este no esta abierto asi que debemos comprobar que lo est�
+	if (id < 0) {
+
+		printk("Este mutex no ha sido abierto a�n. ERROR\n");
+		return -1;
 	}
 
-	printk("Unlock realizado correctamente -> id del mutex = %d\n\n", id_mutex);
+	if (soltar_mutex(id) < 0)
+		return -1;
+
+	printk("Unlock realizado correctamente -> id del mutex = %d\n\n", id);
 	return 0;
 
 }
@@ -763,11 +1408,11 @@ int crear_mutex(char* nombre, int tipo) {
 
 	nombre= (char*)leer_registro(1);
 	tipo = (int)leer_registro(2);
-	
+
 	printk("Tipo: %d\n", tipo);
 
 	//Comprobamos si el nombre no excede los caracteres maximos
-	if (strlen(nombre) > MAX_NOM_MUT) { 
+	if (strlen(nombre) > MAX_NOM_MUT) {
 
 		printk("El nombre del mutex es demasiado largo. ERROR\n");
 		return -1;
@@ -775,7 +1420,7 @@ int crear_mutex(char* nombre, int tipo) {
 
 	//Comprobamos que haya descriptores libres y si lo hay guardamos la posicion del mismo
 	int nuevo_des = descriptor_libre();
-	if (nuevo_des == -1) {
+	if ((nuevo_des == -1) || (*p_proc_actual->n_descriptores == NUM_MUT_PROC)) {
 
 		printk("El proceso no tiene descriptores libres. ERROR\n");
 		return -1;
@@ -793,26 +1438,15 @@ int crear_mutex(char* nombre, int tipo) {
 	while (mutex_creados == NUM_MUT) {
 
 		printk("Alcanzado el maximo de mutex creados. Se va a bloquear el proceso hasta eliminar algun mutex\n");
-		
-		int nivel_int = fijar_nivel_int(NIVEL_3);
-
-		//Cambiamos el estado del proceso a bloqueado
-		p_proc_actual->estado = BLOQUEADO;
-
-		//Lo eliminamos de la lista de procesos listos y lo ponemos en la lista de procesos bloqueados
-		eliminar_primero(&lista_listos);
-		insertar_ultimo(&lista_bloq_mutex, p_proc_actual); 
 
-		//Conseguimos el nuevo proceso actual 
-		BCP* p_proc_bloq = p_proc_actual; 
-		p_proc_actual = planificador();
+		bloquear_proceso(&lista_bloq_mutex);
 
-		//Cambiamos el contexto
-		cambio_contexto(&(p_proc_bloq->contexto_regs), &(p_proc_actual->contexto_regs));
-		printk("Se procede a cambiar el contexto del proceso: %d al proceso: %d\n", p_proc_bloq->id, p_proc_actual->id);
+		//Mientras estaba bloqueado otro proceso ha podido crear un mutex con el mismo nombre
+		if (nombres_iguales(nombre) == -1) {
 
-		//Recuperamos el nivel de interrupcion anterior
-		fijar_nivel_int(nivel_int);
+			printk("Ya existe un mutex con este nombre. ERROR\n");
+			return -1;
+		}
 	}
 
 	//Ahora ya se puede crear el mutex
@@ -820,23 +1454,29 @@ int crear_mutex(char* nombre, int tipo) {
 	int descriptor_mut = descriptor_mutex();
 
 	//A�adir este descriptor al array de descriptores del proceso en la posicion correspondiente
-	p_proc_actual->descriptores[nuevo_des] = descriptor_mut;
+	p_proc_actual->descriptores[nuevo_des].tipo = DESC_MUTEX;
+	p_proc_actual->descriptores[nuevo_des].id = descriptor_mut;
 	printk("Descriptor_proc %d -> descr_mut = %d\n", nuevo_des, descriptor_mut);
 
 	//Actualizar variables mutex
-	array_mutex[descriptor_mut].nombre = nombre;
-	array_mutex[descriptor_mut].tipo = tipo;
-	array_mutex[descriptor_mut].abierto++;
-	array_mutex[descriptor_mut].propietario = p_proc_actual->id;
+	mutex *m = &array_mutex[descriptor_mut];
+	strcpy(m->nombre, nombre);
+	m->tipo = tipo & RECURSIVO;
+	m->traspaso = (tipo & TRASPASO) ? 1 : 0;
+	m->abierto = 1;
+	m->locked = 0;
+	m->propietario = -1;
+	m->n_procesos_esperando = 0;
+	memset(&m->estadisticas, 0, sizeof(m->estadisticas));
 	mutex_creados++;
 
 	//Actualizar variables proceso
-	p_proc_actual->n_descriptores++;
+	(*p_proc_actual->n_descriptores)++;
 
 	printk("Mutex %s creado correctamente\n\n", nombre);
 
 	//Devuelve el descriptor del mutex creado
-	return descriptor_mut; 
+	return nuevo_des;
 
 }
 
@@ -845,7 +1485,7 @@ int abrir_mutex(char* nombre) {
 	printk("SECCI�N ABRIR_MUTEX\n");
 
 	nombre = (char*)leer_registro(1);
-	printk("Abriendo mutex %c\n", nombre);
+	printk("Abriendo mutex %s\n", nombre);
 
 	//Comprobamos que el nombre no supuere el tama�o maximo permitido
 	if (strlen(nombre) > MAX_NOM_MUT) {
@@ -856,25 +1496,18 @@ int abrir_mutex(char* nombre) {
 
 	//Comprobamos que haya descriptores libres y si lo hay guardamos la posicion del mismo
 	int nuevo_des = descriptor_libre();
-	if (nuevo_des == -1) {
+	if ((nuevo_des == -1) || (*p_proc_actual->n_descriptores == NUM_MUT_PROC)) {
 
 		printk("El proceso no tiene descriptores libres. ERROR\n");
 		return -1;
 	}
 
-	//Comprobamos que el nombre del mutex sea igual a otro
-	if (nombres_iguales(nombre) != -1) {
-
-		printk("Ya existe un mutex con este nombre. ERROR\n");
-		return -1;
-	}
-
-	//Iteramos todo el array de mutex creados para encontrar el mutex buscado
-	int nom;
-	for (int i = 0; i < mutex_creados; i++) {
+	//Iteramos todo el array de mutex para encontrar el mutex buscado
+	int nom = -1;
+	for (int i = 0; i < NUM_MUT; i++) {
 
 		//Comprobamos en cada iteraci�n si los nombres son iguales
-		if ((strcmp(nombre, array_mutex[i].nombre)) == 0) {
+		if ((array_mutex[i].abierto != 0) && ((strcmp(nombre, array_mutex[i].nombre)) == 0)) {
 
 			//Una vez encontrado el mutex nos quedamos el descriptor
 			nom = i;
@@ -882,12 +1515,20 @@ int abrir_mutex(char* nombre) {
 		}
 	}
 
+	//Comprobamos que exista un mutex con ese nombre
+	if (nom == -1) {
+
+		printk("No existe ningun mutex con este nombre. ERROR\n");
+		return -1;
+	}
+
 	//Ahora tenemos que asignar el descriptor al proceso actual
-	p_proc_actual->descriptores[nuevo_des] = nom;
+	p_proc_actual->descriptores[nuevo_des].tipo = DESC_MUTEX;
+	p_proc_actual->descriptores[nuevo_des].id = nom;
 
 	//Tenemos que actualizar tambi�n las variables del proceso
-	p_proc_actual->n_descriptores++;
-	array_mutex[nuevo_des].abierto++;
+	(*p_proc_actual->n_descriptores)++;
+	array_mutex[nom].abierto++;
 
 	printk("Se ha abierto el mutex correctamente\n");
 
@@ -896,85 +1537,3959 @@ int abrir_mutex(char* nombre) {
 	return nuevo_des;
 }
 
+//Obtiene todos los mutex de la lista o ninguno. Si alguno lo tiene otro
+//proceso se espera en ese mutex sin retener los demas y luego se vuelve a
+//intentar con la lista entera, por lo que no hay interbloqueos por orden
+int sis_lock_varios() {
+
+	unsigned int *descs = (unsigned int *)leer_registro(1);
+	int n = (int)leer_registro(2);
+	int ids[NUM_DESC_PROC];
+	int tomado[NUM_DESC_PROC]; //Cedido en modo traspaso mientras se esperaba
+	unsigned int inicio = num_ticks;
+	int esperado = 0;
+	mutex *m;
+
+	if (leer_lista_mutex(descs, n, ids) < 0)
+		return -1;
+
+	for (int i = 0; i < n; i++)
+		tomado[i] = 0;
+
+	while (1) {
+
+		int ocupado = -1;
+
+		for (int i = 0; (i < n) && (ocupado == -1); i++) {
+
+			m = &array_mutex[ids[i]];
+
+			if (tomado[i] || (m->locked == 0))
+				continue;
+
+			if (m->propietario != p_proc_actual->id)
+				ocupado = i;
+			else if (m->tipo != RECURSIVO) {
+
+				printk("El mutex %d no es recursivo y ya lo tiene este proceso. ERROR\n", ids[i]);
+				for (int j = 0; j < n; j++)
+					if (tomado[j])
+						ceder_mutex(&array_mutex[ids[j]]);
+				return -1;
+			}
+		}
+
+		if (ocupado == -1)
+			break;
+
+		//No se puede esperar reteniendo los que se han cedido antes. No
+		//han llegado a contar como adquiridos
+		for (int j = 0; j < n; j++)
+			if (tomado[j]) {
+
+				ceder_mutex(&array_mutex[ids[j]]);
+				tomado[j] = 0;
+			}
+
+		m = &array_mutex[ids[ocupado]];
+		m->n_procesos_esperando++;
+		if (m->n_procesos_esperando > m->estadisticas.max_esperando)
+			m->estadisticas.max_esperando = m->n_procesos_esperando;
+
+		esperado = 1;
+		bloquear_proceso(&m->lista_proc_esperando_lock);
+
+		if (m->propietario == p_proc_actual->id)
+			tomado[ocupado] = 1;
+	}
+
+	//Estan todos disponibles: se toman de una vez y solo ahora se anotan,
+	//tambien los cedidos mientras se esperaba
+	for (int i = 0; i < n; i++) {
+
+		m = &array_mutex[ids[i]];
+		if (!tomado[i]) {
+
+			m->locked++;
+			m->propietario = p_proc_actual->id;
+		}
+		if (m->locked == 1)
+			anotar_adquisicion(m, inicio, esperado);
+	}
+
+	return 0;
+}
+
+//Suelta todos los mutex de la lista en orden inverso. Antes se comprueba
+//que el proceso los tiene todos para no dejar la operacion a medias
+int sis_unlock_varios() {
+
+	unsigned int *descs = (unsigned int *)leer_registro(1);
+	int n = (int)leer_registro(2);
+	int ids[NUM_DESC_PROC];
+
+	if (leer_lista_mutex(descs, n, ids) < 0)
+		return -1;
+
+	for (int i = 0; i < n; i++) {
+
+		mutex *m = &array_mutex[ids[i]];
+		if ((m->locked == 0) || (m->propietario != p_proc_actual->id)) {
+
+			printk("El proceso no tiene el mutex %d. ERROR\n", ids[i]);
+			return -1;
+		}
+	}
+
+	for (int i = n - 1; i >= 0; i--)
+		soltar_mutex(ids[i]);
+
+	return 0;
+}
+
 int cerrar_mutex(unsigned int mutexid) {
 
 	printk("SECCI�N CERRAR_MUTEX\n");
 
-	unsigned int id_mutex = (unsigned int)leer_registro(1);
+	mutexid = (unsigned int)leer_registro(1);
 
 	printk("id del mutex recibido: %d\n", mutexid);
-	
 
+	return cerrar_descriptor_mutex(mutexid);
+}
 
-	//Comprobamos que exista el mutex
-	if (array_mutex[mutexid].nombre == NULL) {
+////////// ESTADISTICAS ////////////
 
-		printk("El descriptor buscado no se ha encontrado. ERROR \n");
+int sis_estadisticas_mutex() {
+
+	int id = mutex_de_descriptor((unsigned int)leer_registro(1));
+	struct estad_mutex *est = (struct estad_mutex *)leer_registro(2);
+
+	if ((id < 0) || (est == NULL)) {
+
+		printk("Descriptor de mutex o direccion no validos. ERROR\n");
 		return -1;
 	}
 
-	//Si lo encontramos, lo cerramos
-	p_proc_actual->descriptores[mutexid] = -1;
-	p_proc_actual->n_descriptores--;
-	
-	//Si el mutex no ha sido abierto por ningun proceso se quita directamente
-	if (array_mutex[mutexid].abierto <= 0) {
+	//Si la direccion no es valida exc_mem abortara el proceso
+	int nivel_int = fijar_nivel_int(NIVEL_3);
+	acceso_parametro = 1;
+	*est = array_mutex[id].estadisticas;
+	acceso_parametro = 0;
+	fijar_nivel_int(nivel_int);
 
-		printk("El mutex %d ha sido eliminado\n", mutexid);
-		mutex_creados--;
+	return 0;
+}
 
-		//Si hay algun proceso esperando al mutex debido a que se hab�an creado el maximo de mutex
-		//Hay que desbloquear los procesos bloqueados que estan esperando a este
-		while (lista_bloq_mutex.primero != NULL) {
+//Muestra las estadisticas de los mutex que se han llegado a usar
+static void volcar_estadisticas_mutex() {
 
-			int nivel_int = fijar_nivel_int(NIVEL_3);
+	printk("-> ESTADISTICAS DE MUTEX\n");
+	printk("%-8s %8s %8s %10s %10s %10s %10s %6s\n", "nombre", "adquis.",
+		"esperas", "t.espera", "max.esp.", "t.reten.", "max.ret.", "cola");
 
-			//Cogemos el proceso que esta esperando y lo ponemos a listo
-			BCP* proc_esperando = lista_bloq_mutex.primero;
-			proc_esperando->estado = LISTO;
+	for (int i = 0; i < NUM_MUT; i++) {
 
-			//Lo eliminamos de la lista de procesos bloqueados y lo ponemos en la lista de listos
-			eliminar_primero(&lista_bloq_mutex);
-			insertar_ultimo(&lista_listos, proc_esperando);
+		struct estad_mutex *e = &array_mutex[i].estadisticas;
 
-			//Recuperamos el nivel de interrupci�n anterior
-			fijar_nivel_int(nivel_int);
+		if (e->adquisiciones == 0)
+			continue;
 
-			printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
-		}
+		printk("%-8s %8u %8u %10u %10u %10u %10u %6u\n", array_mutex[i].nombre,
+			e->adquisiciones, e->adquisiciones_con_espera,
+			e->ticks_espera, e->max_ticks_espera,
+			e->ticks_retencion, e->max_ticks_retencion, e->max_esperando);
 	}
+}
 
-	//Si el mutex a cerrar esta bloaqueado, hay que desbloquearlo
-	if (array_mutex[mutexid].propietario == p_proc_actual->id) {
+//Llamada al terminar el ultimo proceso, justo antes de apagarse el sistema
+void volcar_estadisticas() {
 
-		printk("Se procede a desbloquear el mutex\n");
-		array_mutex[mutexid].locked = 0;
+	volcar_estadisticas_mutex();
+	volcar_uso_pilas();
+}
+///////////////
+// SEMAFOROS //
+///////////////
 
-		//Si hay algun proceso esperando al mutex por lock, hay que desbloquearlo
-		while ((array_mutex[mutexid].lista_proc_esperando_lock).primero != NULL) {
+//////// FUNCIONES AUXILIARES //////////
 
-			int nivel_int = fijar_nivel_int(NIVEL_3);
+//Devuelve la posicion del semaforo con ese nombre o -1 si no existe
+static int buscar_sem(char* nombre) {
 
-			//Cogemos el proceso que esta esperando y lo ponemos a listo
-			BCP* proc_esperando = (array_mutex[mutexid].lista_proc_esperando_lock).primero;
-			proc_esperando->estado = LISTO;
+	for (int i = 0; i < NUM_SEM; i++)
+		if ((array_sem[i].abierto != 0) && (strcmp(nombre, array_sem[i].nombre) == 0))
+			return i;
 
-			//Lo eliminamos de la lista de procesos esperando y lo ponemos en la lista de listos
-			eliminar_primero(&(array_mutex[mutexid].lista_proc_esperando_lock));
-			insertar_ultimo(&lista_listos, proc_esperando);
+	return -1;
+}
 
-			//Recuperamos el nivel de interrupci�n anterior
-			fijar_nivel_int(nivel_int);
+int cerrar_descriptor_sem(unsigned int descriptor) {
 
-			printk("Se ha desbloqueado el proceso %d\n", proc_esperando->id);
-		}
+	int id = objeto_de_descriptor(descriptor, DESC_SEMAFORO);
+
+	if (id < 0) {
+
+		printk("El descriptor del semaforo no existe. ERROR\n");
+		return -1;
 	}
 
-	array_mutex[mutexid].abierto--;
-	printk("El mutex %d ha sido cerrado correctamente\n", mutexid);
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	array_sem[id].abierto--;
+
+	//Ningun proceso puede estar esperando en el: todos tendrian un descriptor abierto
+	if (array_sem[id].abierto == 0)
+		printk("El semaforo %d ha sido eliminado\n", id);
 
 	return 0;
 }
+
+////////// LLAMADAS ////////////
+
+int sis_crear_sem() {
+
+	char* nombre = (char*)leer_registro(1);
+	int valor = (int)leer_registro(2);
+	int id;
+
+	if ((strlen(nombre) > MAX_NOM_MUT) || (valor < 0)) {
+
+		printk("Nombre o valor inicial del semaforo no validos. ERROR\n");
+		return -1;
+	}
+
+	if (buscar_sem(nombre) != -1) {
+
+		printk("Ya existe un semaforo con este nombre. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_SEM) && (array_sem[id].abierto != 0); id++);
+	if (id == NUM_SEM) {
+
+		printk("Alcanzado el maximo de semaforos creados. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_SEMAFORO, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	strcpy(array_sem[id].nombre, nombre);
+	array_sem[id].valor = valor;
+	array_sem[id].abierto = 1;
+
+	printk("Semaforo %s creado con valor %d\n", nombre, valor);
+	return nuevo_des;
+}
+
+int sis_abrir_sem() {
+
+	char* nombre = (char*)leer_registro(1);
+
+	int id = buscar_sem(nombre);
+	if (id == -1) {
+
+		printk("No existe ningun semaforo con este nombre. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_SEMAFORO, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	array_sem[id].abierto++;
+	return nuevo_des;
+}
+
+int sis_esperar_sem() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_SEMAFORO);
+
+	if (id < 0) {
+
+		printk("El descriptor del semaforo no existe. ERROR\n");
+		return -1;
+	}
+
+	semaforo *s = &array_sem[id];
+
+	//Si no quedan unidades se bloquea. sis_senalar_sem le cede la suya
+	//directamente, por lo que al despertar no hay que volver a comprobar
+	if (s->valor > 0)
+		s->valor--;
+	else
+		bloquear_proceso(&s->lista_proc_esperando);
+
+	return 0;
+}
+
+int sis_senalar_sem() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_SEMAFORO);
+
+	if (id < 0) {
+
+		printk("El descriptor del semaforo no existe. ERROR\n");
+		return -1;
+	}
+
+	//Despierta a un unico proceso; solo si no hay nadie esperando se incrementa
+	if (desbloquear_primero(&array_sem[id].lista_proc_esperando) == NULL) {
+
+		array_sem[id].valor++;
+		comprobar_esperas_multiples(0);
+	}
+
+	return 0;
+}
+
+int sis_cerrar_sem() {
+
+	return cerrar_descriptor_sem((unsigned int)leer_registro(1));
+}
+
+/////////////////////////
+// VARIABLES CONDICION //
+/////////////////////////
+
+//Devuelve la posicion de la condicion con ese nombre o -1 si no existe
+static int buscar_cond(char* nombre) {
+
+	for (int i = 0; i < NUM_COND; i++)
+		if ((array_cond[i].abierto != 0) && (strcmp(nombre, array_cond[i].nombre) == 0))
+			return i;
+
+	return -1;
+}
+
+int cerrar_descriptor_cond(unsigned int descriptor) {
+
+	int id = objeto_de_descriptor(descriptor, DESC_CONDICION);
+
+	if (id < 0) {
+
+		printk("El descriptor de la condicion no existe. ERROR\n");
+		return -1;
+	}
+
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	array_cond[id].abierto--;
+
+	if (array_cond[id].abierto == 0)
+		printk("La condicion %d ha sido eliminada\n", id);
+
+	return 0;
+}
+
+int sis_crear_cond() {
+
+	char* nombre = (char*)leer_registro(1);
+	int id;
+
+	if (strlen(nombre) > MAX_NOM_MUT) {
+
+		printk("El nombre de la condicion es demasiado largo. ERROR\n");
+		return -1;
+	}
+
+	if (buscar_cond(nombre) != -1) {
+
+		printk("Ya existe una condicion con este nombre. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_COND) && (array_cond[id].abierto != 0); id++);
+	if (id == NUM_COND) {
+
+		printk("Alcanzado el maximo de condiciones creadas. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_CONDICION, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	strcpy(array_cond[id].nombre, nombre);
+	array_cond[id].abierto = 1;
+
+	printk("Condicion %s creada correctamente\n", nombre);
+	return nuevo_des;
+}
+
+int sis_abrir_cond() {
+
+	char* nombre = (char*)leer_registro(1);
+
+	int id = buscar_cond(nombre);
+	if (id == -1) {
+
+		printk("No existe ninguna condicion con este nombre. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_CONDICION, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	array_cond[id].abierto++;
+	return nuevo_des;
+}
+
+//Libera el mutex (que debe tener el proceso actual), espera a que se senale
+//la condicion y vuelve a obtener el mutex antes de retornar
+int sis_esperar_cond() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_CONDICION);
+	int id_mutex = mutex_de_descriptor((unsigned int)leer_registro(2));
+
+	if ((id < 0) || (id_mutex < 0)) {
+
+		printk("Descriptor de condicion o de mutex no valido. ERROR\n");
+		return -1;
+	}
+
+	mutex *m = &array_mutex[id_mutex];
+	if ((m->locked == 0) || (m->propietario != p_proc_actual->id)) {
+
+		printk("El proceso no tiene el mutex asociado a la condicion. ERROR\n");
+		return -1;
+	}
+
+	//Si el mutex es recursivo hay que restaurar las veces que estaba bloqueado
+	int veces = m->locked;
+	liberar_mutex(m);
+
+	bloquear_proceso(&array_cond[id].lista_proc_esperando);
+
+	adquirir_mutex(id_mutex);
+	m->locked = veces;
+	return 0;
+}
+
+int sis_senalar_cond() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_CONDICION);
+
+	if (id < 0) {
+
+		printk("El descriptor de la condicion no existe. ERROR\n");
+		return -1;
+	}
+
+	desbloquear_primero(&array_cond[id].lista_proc_esperando);
+	return 0;
+}
+
+int sis_difundir_cond() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_CONDICION);
+
+	if (id < 0) {
+
+		printk("El descriptor de la condicion no existe. ERROR\n");
+		return -1;
+	}
+
+	desbloquear_todos(&array_cond[id].lista_proc_esperando);
+	return 0;
+}
+
+int sis_cerrar_cond() {
+
+	return cerrar_descriptor_cond((unsigned int)leer_registro(1));
+}
+
+//////////////////////////////////////
+// CERROJOS DE LECTORES/ESCRITORES //
+//////////////////////////////////////
+
+//Devuelve la posicion del cerrojo con ese nombre o -1 si no existe
+static int buscar_cerrojo(char* nombre) {
+
+	for (int i = 0; i < NUM_CERROJOS; i++)
+		if ((array_cerrojos[i].abierto != 0) && (strcmp(nombre, array_cerrojos[i].nombre) == 0))
+			return i;
+
+	return -1;
+}
+
+//Cede el cerrojo, que ha quedado libre, a los procesos que esperan por el.
+//Los escritores reciben el cerrojo de uno en uno y los lectores todos
+//juntos en un unico lote. En ambos casos ya lo tienen al despertar.
+static void ceder_cerrojo(cerrojo *c) {
+
+	BCP* proc;
+	int turno_escritor;
+
+	if (c->lista_escritores.primero == NULL)
+		turno_escritor = 0;
+	else if (c->lista_lectores.primero == NULL)
+		turno_escritor = 1;
+	else
+		turno_escritor = (c->preferencia == PREF_ESCRITORES);
+
+	if (turno_escritor) {
+
+		if (c->lectores > 0)
+			return;
+
+		proc = desbloquear_primero(&c->lista_escritores);
+		c->escritor = proc->id;
+	}
+	else if (c->escritor == -1)
+		c->lectores += desbloquear_todos(&c->lista_lectores);
+}
+
+//Deja el cerrojo que tiene el proceso o hilo proc a traves de un descriptor
+static void soltar_cerrojo(BCP *proc, unsigned int des) {
+
+	descriptor *d = &proc->descriptores[des];
+	cerrojo *c = &array_cerrojos[d->id];
+
+	if (proc->modo_cerrojos[des] == EN_ESCRITURA)
+		c->escritor = -1;
+	else
+		c->lectores--;
+	proc->modo_cerrojos[des] = 0;
+	d->usos--;
+
+	ceder_cerrojo(c);
+}
+
+int cerrar_descriptor_cerrojo(unsigned int des) {
+
+	int id = objeto_de_descriptor(des, DESC_CERROJO);
+
+	if (id < 0) {
+
+		printk("El descriptor del cerrojo no existe. ERROR\n");
+		return -1;
+	}
+
+	//Con hilos el descriptor es comun: no se cierra si otro lo usa
+	descriptor *d = &p_proc_actual->descriptores[des];
+	int mio = (p_proc_actual->modo_cerrojos[des] != 0);
+	if (d->usos > mio) {
+
+		printk("Otro hilo del proceso tiene o espera el cerrojo. ERROR\n");
+		return -1;
+	}
+
+	//Si el proceso tenia el cerrojo lo suelta
+	if (mio)
+		soltar_cerrojo(p_proc_actual, des);
+
+	d->tipo = DESC_LIBRE;
+	array_cerrojos[id].abierto--;
+
+	if (array_cerrojos[id].abierto == 0)
+		printk("El cerrojo %d ha sido eliminado\n", id);
+
+	return 0;
+}
+
+int sis_crear_cerrojo() {
+
+	char* nombre = (char*)leer_registro(1);
+	int preferencia = (int)leer_registro(2);
+	int id;
+
+	if (strlen(nombre) > MAX_NOM_MUT) {
+
+		printk("El nombre del cerrojo es demasiado largo. ERROR\n");
+		return -1;
+	}
+
+	if (buscar_cerrojo(nombre) != -1) {
+
+		printk("Ya existe un cerrojo con este nombre. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_CERROJOS) && (array_cerrojos[id].abierto != 0); id++);
+	if (id == NUM_CERROJOS) {
+
+		printk("Alcanzado el maximo de cerrojos creados. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_CERROJO, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	cerrojo *c = &array_cerrojos[id];
+	strcpy(c->nombre, nombre);
+	c->preferencia = (preferencia == PREF_ESCRITORES) ? PREF_ESCRITORES : PREF_LECTORES;
+	c->abierto = 1;
+	c->lectores = 0;
+	c->escritor = -1;
+
+	printk("Cerrojo %s creado correctamente\n", nombre);
+	return nuevo_des;
+}
+
+int sis_abrir_cerrojo() {
+
+	char* nombre = (char*)leer_registro(1);
+
+	int id = buscar_cerrojo(nombre);
+	if (id == -1) {
+
+		printk("No existe ningun cerrojo con este nombre. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_CERROJO, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	array_cerrojos[id].abierto++;
+	return nuevo_des;
+}
+
+int sis_lock_lectura() {
+
+	unsigned int des = (unsigned int)leer_registro(1);
+	int id = objeto_de_descriptor(des, DESC_CERROJO);
+
+	if ((id < 0) || (p_proc_actual->modo_cerrojos[des] != 0)) {
+
+		printk("Descriptor de cerrojo no valido o ya adquirido. ERROR\n");
+		return -1;
+	}
+
+	cerrojo *c = &array_cerrojos[id];
+	p_proc_actual->descriptores[des].usos++;
+
+	//Con preferencia de escritores no se adelanta a los que esperan
+	if ((c->escritor == -1) && ((c->preferencia == PREF_LECTORES) || (c->lista_escritores.primero == NULL)))
+		c->lectores++;
+	else
+		bloquear_proceso(&c->lista_lectores); //ceder_cerrojo ya nos cuenta como lectores
+
+	p_proc_actual->modo_cerrojos[des] = EN_LECTURA;
+	return 0;
+}
+
+int sis_lock_escritura() {
+
+	unsigned int des = (unsigned int)leer_registro(1);
+	int id = objeto_de_descriptor(des, DESC_CERROJO);
+
+	if ((id < 0) || (p_proc_actual->modo_cerrojos[des] != 0)) {
+
+		printk("Descriptor de cerrojo no valido o ya adquirido. ERROR\n");
+		return -1;
+	}
+
+	cerrojo *c = &array_cerrojos[id];
+	p_proc_actual->descriptores[des].usos++;
+
+	if ((c->escritor == -1) && (c->lectores == 0))
+		c->escritor = p_proc_actual->id;
+	else
+		bloquear_proceso(&c->lista_escritores); //ceder_cerrojo ya nos ha hecho escritor
+
+	p_proc_actual->modo_cerrojos[des] = EN_ESCRITURA;
+	return 0;
+}
+
+int sis_unlock_cerrojo() {
+
+	unsigned int des = (unsigned int)leer_registro(1);
+	int id = objeto_de_descriptor(des, DESC_CERROJO);
+
+	//Cada hilo solo puede soltar el cerrojo que tiene el mismo
+	if ((id < 0) || (p_proc_actual->modo_cerrojos[des] == 0)) {
+
+		printk("El proceso no tiene el cerrojo. ERROR\n");
+		return -1;
+	}
+
+	soltar_cerrojo(p_proc_actual, des);
+	return 0;
+}
+
+int sis_cerrar_cerrojo() {
+
+	return cerrar_descriptor_cerrojo((unsigned int)leer_registro(1));
+}
+
+//////////////
+// BARRERAS //
+//////////////
+
+//Devuelve la posicion de la barrera con ese nombre o -1 si no existe
+static int buscar_barrera(char* nombre) {
+
+	for (int i = 0; i < NUM_BARRERAS; i++)
+		if ((array_barreras[i].abierto != 0) && (strcmp(nombre, array_barreras[i].nombre) == 0))
+			return i;
+
+	return -1;
+}
+
+int cerrar_descriptor_barrera(unsigned int descriptor) {
+
+	int id = objeto_de_descriptor(descriptor, DESC_BARRERA);
+
+	if (id < 0) {
+
+		printk("El descriptor de la barrera no existe. ERROR\n");
+		return -1;
+	}
+
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	array_barreras[id].abierto--;
+
+	if (array_barreras[id].abierto == 0)
+		printk("La barrera %d ha sido eliminada\n", id);
+
+	return 0;
+}
+
+int sis_crear_barrera() {
+
+	char* nombre = (char*)leer_registro(1);
+	int participantes = (int)leer_registro(2);
+	int id;
+
+	if ((strlen(nombre) > MAX_NOM_MUT) || (participantes < 1)) {
+
+		printk("Nombre o numero de participantes de la barrera no validos. ERROR\n");
+		return -1;
+	}
+
+	if (buscar_barrera(nombre) != -1) {
+
+		printk("Ya existe una barrera con este nombre. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_BARRERAS) && (array_barreras[id].abierto != 0); id++);
+	if (id == NUM_BARRERAS) {
+
+		printk("Alcanzado el maximo de barreras creadas. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_BARRERA, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	barrera *b = &array_barreras[id];
+	strcpy(b->nombre, nombre);
+	b->abierto = 1;
+	b->participantes = participantes;
+	b->llegados = 0;
+
+	printk("Barrera %s creada para %d procesos\n", nombre, participantes);
+	return nuevo_des;
+}
+
+int sis_abrir_barrera() {
+
+	char* nombre = (char*)leer_registro(1);
+
+	int id = buscar_barrera(nombre);
+	if (id == -1) {
+
+		printk("No existe ninguna barrera con este nombre. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_BARRERA, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	array_barreras[id].abierto++;
+	return nuevo_des;
+}
+
+//Bloquea al proceso hasta que llegan todos los participantes. El ultimo en
+//llegar pasa a listos a todos los demas de una vez y devuelve 1; el resto 0
+int sis_esperar_barrera() {
+
+	int id = objeto_de_descriptor((unsigned int)leer_registro(1), DESC_BARRERA);
+
+	if (id < 0) {
+
+		printk("El descriptor de la barrera no existe. ERROR\n");
+		return -1;
+	}
+
+	barrera *b = &array_barreras[id];
+
+	b->llegados++;
+	if (b->llegados < b->participantes) {
+
+		bloquear_proceso(&b->lista_proc_esperando);
+		return 0;
+	}
+
+	//La barrera queda lista para la siguiente fase
+	b->llegados = 0;
+	desbloquear_todos(&b->lista_proc_esperando);
+	return 1;
+}
+
+int sis_cerrar_barrera() {
+
+	return cerrar_descriptor_barrera((unsigned int)leer_registro(1));
+}
+
+//////////////
+// TERMINAL //
+//////////////
+
+int sis_leer_caracter() {
+
+	char car;
+	int nivel = fijar_nivel_int(NIVEL_2);
+
+	//Se inhiben las interrupciones del terminal mientras se consulta el buffer
+	while (num_car_terminal == 0)
+		bloquear_proceso(&lista_bloq_terminal);
+
+	car = buffer_terminal[primer_car_terminal];
+	primer_car_terminal = (primer_car_terminal + 1) % TAM_BUF_TERM;
+	num_car_terminal--;
+
+	fijar_nivel_int(nivel);
+	return car;
+}
+
+/////////////////////
+// ESPERA MULTIPLE //
+/////////////////////
+
+//Devuelve la posicion del primer evento del proceso que esta listo o -1
+//si no hay ninguno. No consume ni adquiere nada
+static int primer_evento_listo(BCP *p) {
+
+	for (int i = 0; i < p->n_eventos; i++) {
+
+		int id = p->eventos[i].desc;
+
+		switch (p->eventos[i].tipo) {
+		case EVENTO_MUTEX:
+			if (array_mutex[id].locked == 0)
+				return i;
+			break;
+		case EVENTO_SEM:
+			if (array_sem[id].valor > 0)
+				return i;
+			break;
+		case EVENTO_TERMINAL:
+			if (num_car_terminal > 0)
+				return i;
+			break;
+		}
+	}
+
+	return -1;
+}
+
+//Pasa a listos a los procesos de lista_espera_multiple que tienen algun
+//evento listo. Si se invoca desde la interrupcion de reloj (tick=1) ademas
+//descuenta el plazo de espera de cada uno
+void comprobar_esperas_multiples(int tick) {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+	BCPptr aux = lista_espera_multiple.primero;
+
+	while (aux != NULL) {
+
+		BCPptr siguiente = aux->siguiente;
+		int listo = primer_evento_listo(aux);
+
+		if ((listo == -1) && tick && (aux->ticks_timeout > 0))
+			if (--aux->ticks_timeout == 0)
+				listo = ESPERA_TIMEOUT;
+
+		if (listo != -1) {
+
+			aux->evento_listo = listo;
+			aux->estado = LISTO;
+			eliminar_elem(&lista_espera_multiple, aux);
+			insertar_ultimo(&lista_listos, aux);
+		}
+
+		aux = siguiente;
+	}
+
+	fijar_nivel_int(nivel);
+}
+
+//Espera hasta que alguno de los eventos este listo o venza el plazo (en ms,
+//negativo sin limite, 0 solo consulta). Devuelve la posicion del evento
+//listo, ESPERA_TIMEOUT o -1 si hay error. Solo avisa: para obtener el
+//mutex o la unidad del semaforo hay que hacer despues lock o esperar_sem
+int sis_esperar_multiple() {
+
+	struct evento *eventos = (struct evento *)leer_registro(1);
+	int n = (int)leer_registro(2);
+	int timeout = (int)leer_registro(3);
+	int nivel, listo;
+
+	if ((n < 0) || (n > MAX_EVENTOS) || ((n == 0) && (timeout < 0))) {
+
+		printk("Numero de eventos no valido. ERROR\n");
+		return -1;
+	}
+
+	//Se copian los eventos al BCP traduciendo cada descriptor al objeto
+	for (int i = 0; i < n; i++) {
+
+		nivel = fijar_nivel_int(NIVEL_3);
+		acceso_parametro = 1;
+		struct evento ev = eventos[i];
+		acceso_parametro = 0;
+		fijar_nivel_int(nivel);
+
+		int id = 0;
+		if (ev.tipo == EVENTO_MUTEX)
+			id = mutex_de_descriptor(ev.desc);
+		else if (ev.tipo == EVENTO_SEM)
+			id = objeto_de_descriptor(ev.desc, DESC_SEMAFORO);
+		else if (ev.tipo != EVENTO_TERMINAL)
+			id = -1;
+
+		if (id < 0) {
+
+			printk("Evento %d no valido. ERROR\n", i);
+			return -1;
+		}
+
+		p_proc_actual->eventos[i].tipo = ev.tipo;
+		p_proc_actual->eventos[i].desc = id;
+	}
+	p_proc_actual->n_eventos = n;
+
+	//Entre la comprobacion y el bloqueo no puede llegar ningun evento
+	nivel = fijar_nivel_int(NIVEL_3);
+
+	listo = primer_evento_listo(p_proc_actual);
+	if ((listo == -1) && (timeout == 0))
+		listo = ESPERA_TIMEOUT;
+
+	if (listo == -1) {
+
+		p_proc_actual->ticks_timeout = (timeout < 0) ? -1 : (timeout * TICK + 999) / 1000;
+		bloquear_proceso(&lista_espera_multiple);
+		listo = p_proc_actual->evento_listo;
+	}
+
+	p_proc_actual->n_eventos = 0;
+	fijar_nivel_int(nivel);
+	return listo;
+}
+
+//////////////
+// TUBERIAS //
+//////////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Copia n bytes entre el espacio del usuario y el del kernel. Un acceso
+//erroneo a la direccion del usuario termina el proceso en exc_mem
+void copiar_parametro(void *destino, const void *origen, int n) {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+	acceso_parametro = 1;
+	memcpy(destino, origen, n);
+	acceso_parametro = 0;
+	fijar_nivel_int(nivel);
+}
+
+//Devuelve la tuberia asociada a un descriptor del extremo indicado
+static tuberia *tuberia_de_descriptor(unsigned int descriptor, int tipo) {
+
+	int id = objeto_de_descriptor(descriptor, tipo);
+
+	if (id < 0)
+		return NULL;
+
+	return &array_tuberias[id];
+}
+
+int cerrar_descriptor_tuberia(unsigned int des) {
+
+	if (des >= NUM_DESC_PROC)
+		return -1;
+
+	descriptor *d = &p_proc_actual->descriptores[des];
+	tuberia *t = &array_tuberias[d->id];
+
+	if (d->tipo == DESC_TUBERIA_LECTURA) {
+
+		//Sin lectores los escritores bloqueados ya no pueden continuar
+		if (--t->lectores == 0)
+			desbloquear_todos(&t->lista_escritores);
+	}
+	else if (d->tipo == DESC_TUBERIA_ESCRITURA) {
+
+		//Sin escritores los lectores bloqueados reciben fin de fichero
+		if (--t->escritores == 0)
+			desbloquear_todos(&t->lista_lectores);
+	}
+	else
+		return -1;
+
+	d->tipo = DESC_LIBRE;
+	return 0;
+}
+
+//El proceso hijo recibe copia de los descriptores de tuberia del proceso
+//actual en las mismas posiciones, de modo que se pueden montar cadenas de
+//procesos. El resto de objetos tiene nombre y se puede abrir de nuevo
+void heredar_descriptores(BCP *hijo) {
+
+	if (p_proc_actual == NULL)
+		return;
+
+	for (int i = 0; i < NUM_DESC_PROC; i++) {
+
+		descriptor *d = &p_proc_actual->descriptores[i];
+
+		if (d->tipo == DESC_TUBERIA_LECTURA)
+			array_tuberias[d->id].lectores++;
+		else if (d->tipo == DESC_TUBERIA_ESCRITURA)
+			array_tuberias[d->id].escritores++;
+		else
+			continue;
+
+		hijo->descriptores[i] = *d;
+	}
+}
+
+////////// LLAMADAS ////////////
+
+//Crea una tuberia y devuelve en descs[0] el descriptor de lectura y en
+//descs[1] el de escritura
+int sis_crear_tuberia() {
+
+	int *descs = (int *)leer_registro(1);
+	int id, nuevos[2];
+
+	for (id = 0; (id < NUM_TUBERIAS) &&
+		((array_tuberias[id].lectores != 0) || (array_tuberias[id].escritores != 0)); id++);
+	if (id == NUM_TUBERIAS) {
+
+		printk("Alcanzado el maximo de tuberias creadas. ERROR\n");
+		return -1;
+	}
+
+	if ((nuevos[0] = asignar_descriptor(DESC_TUBERIA_LECTURA, id)) == -1)
+		return -1;
+
+	if ((nuevos[1] = asignar_descriptor(DESC_TUBERIA_ESCRITURA, id)) == -1) {
+
+		p_proc_actual->descriptores[nuevos[0]].tipo = DESC_LIBRE;
+		return -1;
+	}
+
+	tuberia *t = &array_tuberias[id];
+	t->primero = 0;
+	t->ocupados = 0;
+	t->lectores = 1;
+	t->escritores = 1;
+
+	copiar_parametro(descs, nuevos, sizeof(nuevos));
+	return 0;
+}
+
+//Lee hasta tam bytes. Se bloquea mientras la tuberia este vacia y tenga
+//escritores; sin escritores devuelve 0 (fin de fichero)
+int sis_leer_tuberia() {
+
+	tuberia *t = tuberia_de_descriptor((unsigned int)leer_registro(1), DESC_TUBERIA_LECTURA);
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	int n, trozo;
+
+	if ((t == NULL) || (tam < 0)) {
+
+		printk("Descriptor de lectura de tuberia no valido. ERROR\n");
+		return -1;
+	}
+
+	while ((t->ocupados == 0) && (t->escritores > 0))
+		bloquear_proceso(&t->lista_lectores);
+
+	//Se copia en como mucho dos trozos: hasta el final del buffer y desde
+	//el principio
+	n = (tam < t->ocupados) ? tam : t->ocupados;
+	trozo = TAM_BUF_TUBERIA - t->primero;
+	if (trozo > n)
+		trozo = n;
+
+	copiar_parametro(buf, &t->buffer[t->primero], trozo);
+	copiar_parametro(buf + trozo, t->buffer, n - trozo);
+
+	t->primero = (t->primero + n) % TAM_BUF_TUBERIA;
+	t->ocupados -= n;
+
+	//Se despierta a un solo escritor, y a otro lector si aun quedan datos
+	if (n > 0)
+		desbloquear_primero(&t->lista_escritores);
+	if (t->ocupados > 0)
+		desbloquear_primero(&t->lista_lectores);
+
+	return n;
+}
+
+//Escribe tam bytes bloqueandose cada vez que la tuberia se llena. Si no
+//quedan lectores devuelve -1, o los bytes escritos hasta ese momento
+int sis_escribir_tuberia() {
+
+	tuberia *t = tuberia_de_descriptor((unsigned int)leer_registro(1), DESC_TUBERIA_ESCRITURA);
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	int escritos = 0;
+
+	if ((t == NULL) || (tam < 0)) {
+
+		printk("Descriptor de escritura de tuberia no valido. ERROR\n");
+		return -1;
+	}
+
+	while (escritos < tam) {
+
+		while ((t->ocupados == TAM_BUF_TUBERIA) && (t->lectores > 0))
+			bloquear_proceso(&t->lista_escritores);
+
+		if (t->lectores == 0) {
+
+			printk("Tuberia sin lectores. ERROR\n");
+			return (escritos > 0) ? escritos : -1;
+		}
+
+		int fin = (t->primero + t->ocupados) % TAM_BUF_TUBERIA;
+		int n = TAM_BUF_TUBERIA - t->ocupados;
+		int trozo = TAM_BUF_TUBERIA - fin;
+
+		if (n > tam - escritos)
+			n = tam - escritos;
+		if (trozo > n)
+			trozo = n;
+
+		copiar_parametro(&t->buffer[fin], buf + escritos, trozo);
+		copiar_parametro(t->buffer, buf + escritos + trozo, n - trozo);
+
+		t->ocupados += n;
+		escritos += n;
+
+		desbloquear_primero(&t->lista_lectores);
+	}
+
+	//Si queda sitio puede seguir otro escritor
+	if (t->ocupados < TAM_BUF_TUBERIA)
+		desbloquear_primero(&t->lista_escritores);
+
+	return escritos;
+}
+
+int sis_cerrar_tuberia() {
+
+	unsigned int des = (unsigned int)leer_registro(1);
+
+	if ((objeto_de_descriptor(des, DESC_TUBERIA_LECTURA) < 0) &&
+		(objeto_de_descriptor(des, DESC_TUBERIA_ESCRITURA) < 0)) {
+
+		printk("El descriptor de la tuberia no existe. ERROR\n");
+		return -1;
+	}
+
+	return cerrar_descriptor_tuberia(des);
+}
+
+////////////////////////
+// MEMORIA COMPARTIDA //
+////////////////////////
+
+//Devuelve la posicion del segmento con ese nombre o -1 si no existe
+static int buscar_segmento(char* nombre) {
+
+	for (int i = 0; i < NUM_SEGMENTOS; i++)
+		if ((array_segmentos[i].abierto != 0) && (strcmp(nombre, array_segmentos[i].nombre) == 0))
+			return i;
+
+	return -1;
+}
+
+int cerrar_descriptor_segmento(unsigned int descriptor) {
+
+	int id = objeto_de_descriptor(descriptor, DESC_SEGMENTO);
+
+	if (id < 0) {
+
+		printk("El descriptor del segmento no existe. ERROR\n");
+		return -1;
+	}
+
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	array_segmentos[id].abierto--;
+
+	//Al desasociarse el ultimo proceso se libera la memoria
+	if (array_segmentos[id].abierto == 0) {
+
+		free(array_segmentos[id].dir);
+		array_segmentos[id].dir = NULL;
+		printk("El segmento %d ha sido eliminado\n", id);
+	}
+
+	return 0;
+}
+
+//Crea un segmento de tam bytes a cero y asocia a el al proceso actual.
+//Devuelve el descriptor y en *dir la direccion del segmento (las llamadas
+//solo pueden devolver un int)
+int sis_crear_segmento() {
+
+	char* nombre = (char*)leer_registro(1);
+	int tam = (int)leer_registro(2);
+	void **dir = (void **)leer_registro(3);
+	int id;
+
+	if ((strlen(nombre) > MAX_NOM_MUT) || (tam <= 0)) {
+
+		printk("Nombre o tamano del segmento no validos. ERROR\n");
+		return -1;
+	}
+
+	if (buscar_segmento(nombre) != -1) {
+
+		printk("Ya existe un segmento con este nombre. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_SEGMENTOS) && (array_segmentos[id].abierto != 0); id++);
+	if (id == NUM_SEGMENTOS) {
+
+		printk("Alcanzado el maximo de segmentos creados. ERROR\n");
+		return -1;
+	}
+
+	void *zona = calloc(1, tam);
+	if (zona == NULL) {
+
+		printk("No hay memoria para el segmento. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_SEGMENTO, id);
+	if (nuevo_des == -1) {
+
+		free(zona);
+		return -1;
+	}
+
+	strcpy(array_segmentos[id].nombre, nombre);
+	array_segmentos[id].dir = zona;
+	array_segmentos[id].tam = tam;
+	array_segmentos[id].abierto = 1;
+
+	copiar_parametro(dir, &zona, sizeof(zona));
+
+	printk("Segmento %s de %d bytes creado\n", nombre, tam);
+	return nuevo_des;
+}
+
+//Asocia al proceso actual a un segmento existente. Devuelve el descriptor,
+//en *dir la direccion y en *tam el tamano del segmento
+int sis_asociar_segmento() {
+
+	char* nombre = (char*)leer_registro(1);
+	void **dir = (void **)leer_registro(2);
+	int *tam = (int *)leer_registro(3);
+
+	int id = buscar_segmento(nombre);
+	if (id == -1) {
+
+		printk("No existe ningun segmento con este nombre. ERROR\n");
+		return -1;
+	}
+
+	int nuevo_des = asignar_descriptor(DESC_SEGMENTO, id);
+	if (nuevo_des == -1)
+		return -1;
+
+	array_segmentos[id].abierto++;
+
+	copiar_parametro(dir, &array_segmentos[id].dir, sizeof(void *));
+	if (tam != NULL)
+		copiar_parametro(tam, &array_segmentos[id].tam, sizeof(int));
+
+	return nuevo_des;
+}
+
+int sis_desasociar_segmento() {
+
+	return cerrar_descriptor_segmento((unsigned int)leer_registro(1));
+}
+
+//////////////
+// MENSAJES //
+//////////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Comprueba que pid es un proceso existente distinto del actual
+static int pid_valido(int pid) {
+
+	return (pid != p_proc_actual->id) && (buscar_proceso(pid) != NULL);
+}
+
+//Copia el mensaje del emisor en el buffer del receptor, que recibe el
+//tamano y el identificador del emisor
+static void entregar_mensaje(BCP *emisor, BCP *receptor) {
+
+	int n = (emisor->ipc_tam < receptor->ipc_tam) ? emisor->ipc_tam : receptor->ipc_tam;
+
+	copiar_parametro(receptor->ipc_buf, emisor->ipc_buf, n);
+	receptor->ipc_resultado = n;
+	receptor->ipc_pid = emisor->id;
+}
+
+//Pasa a listo un proceso bloqueado en lista_bloq_ipc
+static void despertar_ipc(BCP *proc) {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	eliminar_elem(&lista_bloq_ipc, proc);
+	proc->estado = LISTO;
+	insertar_ultimo(&lista_listos, proc);
+
+	fijar_nivel_int(nivel);
+}
+
+//Bloquea el proceso actual en lista_bloq_ipc y le cede la UCP a destino,
+//que tambien estaba ahi, sin pasar por planificador. El destino sigue
+//con lo que le quedaba de rodaja al proceso actual
+static void cambio_directo(BCP *destino) {
+
+	BCP *p_proc_bloq = p_proc_actual;
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	eliminar_elem(&lista_bloq_ipc, destino);
+	eliminar_primero(&lista_listos);
+
+	p_proc_bloq->estado = BLOQUEADO;
+	p_proc_bloq->tick_bloqueo = num_ticks;
+	encolar_reclamo(p_proc_bloq);
+	insertar_ultimo(&lista_bloq_ipc, p_proc_bloq);
+	destino->estado = LISTO;
+	insertar_primero(&lista_listos, destino);
+
+	p_proc_actual = destino;
+	proteger_regiones(destino);
+	restaurar_pila(destino);
+	cambio_contexto(&(p_proc_bloq->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	fijar_nivel_int(nivel);
+}
+
+//Parte comun de enviar y llamar. En llamar la respuesta se deja en el
+//mismo buffer, que debe tener sitio para TAM_MENSAJE bytes
+static int enviar_mensaje(int llamada) {
+
+	int pid = (int)leer_registro(1);
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	BCP *yo = p_proc_actual;
+
+	if (!pid_valido(pid) || (tam < 0) || (tam > TAM_MENSAJE)) {
+
+		printk("Destino o tamano del mensaje no validos. ERROR\n");
+		return -1;
+	}
+
+	BCP *dest = buscar_proceso(pid);
+
+	yo->ipc_estado = llamada ? IPC_LLAMANDO : IPC_ENVIANDO;
+	yo->ipc_pid = pid;
+	yo->ipc_buf = buf;
+	yo->ipc_tam = tam;
+	yo->ipc_resultado = 0;
+
+	//Si el destino no esta ya recibiendo se espera a que lo haga
+	if ((dest->ipc_estado != IPC_RECIBIENDO) ||
+		((dest->ipc_pid != -1) && (dest->ipc_pid != yo->id))) {
+
+		bloquear_proceso(&dest->emisores);
+		yo->ipc_estado = IPC_NADA;
+		return yo->ipc_resultado;
+	}
+
+	entregar_mensaje(yo, dest);
+	dest->ipc_estado = IPC_NADA;
+
+	if (!llamada) {
+
+		despertar_ipc(dest);
+		yo->ipc_estado = IPC_NADA;
+		return 0;
+	}
+
+	//Mientras se espera la respuesta se cede la UCP directamente al receptor
+	yo->ipc_estado = IPC_ESPERANDO_RESPUESTA;
+	yo->ipc_tam = TAM_MENSAJE;
+	cambio_directo(dest);
+
+	yo->ipc_estado = IPC_NADA;
+	return yo->ipc_resultado;
+}
+
+//Parte comun de recibir y responder_y_recibir. Si no hay ningun emisor
+//esperando se bloquea; si ademas hay un cliente al que se acaba de
+//responder, se le cede la UCP directamente
+static int recibir_mensaje(int *pid, char *buf, int tam, BCP *cliente) {
+
+	BCP *yo = p_proc_actual;
+	BCP *emisor;
+	int origen;
+
+	copiar_parametro(&origen, pid, sizeof(int));
+
+	if (((origen != -1) && !pid_valido(origen)) || (tam < 0)) {
+
+		printk("Origen o tamano del mensaje no validos. ERROR\n");
+		if (cliente != NULL)
+			despertar_ipc(cliente);
+		return -1;
+	}
+
+	yo->ipc_pid = origen;
+	yo->ipc_buf = buf;
+	yo->ipc_tam = (tam < TAM_MENSAJE) ? tam : TAM_MENSAJE;
+
+	for (emisor = yo->emisores.primero;
+		(emisor != NULL) && (origen != -1) && (emisor->id != origen);
+		emisor = emisor->siguiente);
+
+	if (emisor != NULL) {
+
+		int nivel = fijar_nivel_int(NIVEL_3);
+
+		entregar_mensaje(emisor, yo);
+		eliminar_elem(&yo->emisores, emisor);
+
+		//Quien llama sigue bloqueado hasta que se le responda
+		if (emisor->ipc_estado == IPC_LLAMANDO) {
+
+			emisor->ipc_estado = IPC_ESPERANDO_RESPUESTA;
+			emisor->ipc_tam = TAM_MENSAJE;
+			insertar_ultimo(&lista_bloq_ipc, emisor);
+		}
+		else {
+
+			emisor->estado = LISTO;
+			insertar_ultimo(&lista_listos, emisor);
+		}
+
+		fijar_nivel_int(nivel);
+
+		if (cliente != NULL)
+			despertar_ipc(cliente);
+	}
+	else {
+
+		yo->ipc_estado = IPC_RECIBIENDO;
+		if (cliente != NULL)
+			cambio_directo(cliente);
+		else
+			bloquear_proceso(&lista_bloq_ipc);
+		yo->ipc_estado = IPC_NADA;
+	}
+
+	if (yo->ipc_resultado >= 0)
+		copiar_parametro(pid, &yo->ipc_pid, sizeof(int));
+
+	return yo->ipc_resultado;
+}
+
+//Copia la respuesta en el buffer de un proceso bloqueado en llamar sobre
+//el proceso actual. Devuelve ese proceso o NULL si no hay tal llamada
+static BCP *entregar_respuesta(int pid, char *buf, int tam) {
+
+	BCP *yo = p_proc_actual;
+
+	BCP *cliente = pid_valido(pid) ? buscar_proceso(pid) : NULL;
+
+	if ((cliente == NULL) || (tam < 0) || (tam > TAM_MENSAJE) ||
+		(cliente->ipc_estado != IPC_ESPERANDO_RESPUESTA) ||
+		(cliente->ipc_pid != yo->id)) {
+
+		printk("El proceso %d no espera respuesta de este proceso. ERROR\n", pid);
+		return NULL;
+	}
+
+	yo->ipc_buf = buf;
+	yo->ipc_tam = tam;
+	entregar_mensaje(yo, cliente);
+
+	//Ya respondido: otra respuesta a la misma llamada debe fallar
+	cliente->ipc_estado = IPC_NADA;
+	return cliente;
+}
+
+//Al terminar un proceso fallan las operaciones que dependian de el
+void cancelar_mensajes() {
+
+	BCP *yo = p_proc_actual;
+	BCP *proc, *siguiente;
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	while ((proc = yo->emisores.primero) != NULL) {
+
+		eliminar_primero(&yo->emisores);
+		proc->ipc_resultado = -1;
+		proc->estado = LISTO;
+		insertar_ultimo(&lista_listos, proc);
+	}
+
+	for (proc = lista_bloq_ipc.primero; proc != NULL; proc = siguiente) {
+
+		siguiente = proc->siguiente;
+		if (proc->ipc_pid == yo->id) {
+
+			proc->ipc_resultado = -1;
+			despertar_ipc(proc);
+		}
+	}
+
+	yo->ipc_estado = IPC_NADA;
+	fijar_nivel_int(nivel);
+}
+
+////////// LLAMADAS ////////////
+
+//Envia un mensaje y espera a que el destino lo reciba
+int sis_enviar() {
+
+	return enviar_mensaje(0);
+}
+
+//Recibe un mensaje de *pid (-1 de cualquiera). Devuelve su tamano y en
+//*pid quien lo envio
+int sis_recibir() {
+
+	return recibir_mensaje((int *)leer_registro(1), (char *)leer_registro(2),
+		(int)leer_registro(3), NULL);
+}
+
+//Envia un mensaje y espera la respuesta en el mismo buffer. Devuelve el
+//tamano de la respuesta
+int sis_llamar() {
+
+	return enviar_mensaje(1);
+}
+
+//Responde a un proceso bloqueado en llamar sin bloquearse
+int sis_responder() {
+
+	BCP *cliente = entregar_respuesta((int)leer_registro(1), (char *)leer_registro(2),
+		(int)leer_registro(3));
+
+	if (cliente == NULL)
+		return -1;
+
+	despertar_ipc(cliente);
+	return 0;
+}
+
+//Responde al proceso *pid y recibe el siguiente mensaje de cualquiera en
+//el mismo buffer. Si no hay mensajes pendientes la UCP pasa directamente
+//al cliente, por lo que una llamada completa cuesta dos cambios de contexto
+int sis_responder_y_recibir() {
+
+	int *pid = (int *)leer_registro(1);
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	int destino, cualquiera = -1;
+
+	copiar_parametro(&destino, pid, sizeof(int));
+
+	BCP *cliente = entregar_respuesta(destino, buf, tam);
+	if (cliente == NULL)
+		return -1;
+
+	copiar_parametro(pid, &cualquiera, sizeof(int));
+	return recibir_mensaje(pid, buf, TAM_MENSAJE, cliente);
+}
+
+////////////
+// AVISOS //
+////////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Anota avisos para un proceso y lo despierta si los estaba esperando
+static void anotar_avisos(BCP *proc, int avisos) {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	proc->avisos_pendientes |= avisos;
+
+	if (proc->estado == BLOQUEADO) {
+
+		BCP *aux;
+		for (aux = lista_espera_avisos.primero; (aux != NULL) && (aux != proc); aux = aux->siguiente);
+
+		if (aux != NULL) {
+
+			eliminar_elem(&lista_espera_avisos, proc);
+			proc->estado = LISTO;
+			insertar_ultimo(&lista_listos, proc);
+		}
+	}
+
+	fijar_nivel_int(nivel);
+}
+
+//Se invoca justo antes de volver a modo usuario. Si el proceso actual
+//tiene avisos y manejador, se salva la continuacion del kernel y se pasa
+//a ejecutar la funcion de entrada de la biblioteca en su propia pila. Esta
+//recoge todos los avisos pendientes de una vez con tomar_avisos, llama al
+//manejador y termina con fin_avisos, que reanuda la continuacion salvada
+void entregar_avisos() {
+
+	BCP *p = p_proc_actual;
+
+	while ((p->avisos_pendientes != 0) && (p->entrada_avisos != NULL) && !p->en_manejador) {
+
+		contexto_t contexto_avisos;
+
+		p->en_manejador = 1;
+		fijar_contexto_ini(p->info_mem, p->pila_avisos, TAM_PILA_AVISOS,
+			p->entrada_avisos, &contexto_avisos);
+		cambio_contexto(&(p->contexto_interrumpido), &contexto_avisos);
+	}
+}
+
+//Descuenta un tick de las alarmas programadas. Se invoca desde int_reloj
+void cuentaAtrasAlarmas() {
+
+	BCP **pp = &procs_alarma;
+
+	while (*pp != NULL) {
+
+		BCP *p = *pp;
+
+		if (--p->ticks_alarma == 0) {
+
+			*pp = p->siguiente_alarma;
+			anotar_avisos(p, AVISO_ALARMA);
+		}
+		else
+			pp = &p->siguiente_alarma;
+	}
+}
+
+//Cancela la alarma programada del proceso, si la tiene
+void quitar_alarma(BCP *proc) {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	if (proc->ticks_alarma > 0) {
+
+		BCP **pp = &procs_alarma;
+
+		while (*pp != proc)
+			pp = &(*pp)->siguiente_alarma;
+		*pp = proc->siguiente_alarma;
+		proc->ticks_alarma = 0;
+	}
+
+	fijar_nivel_int(nivel);
+}
+
+////////// LLAMADAS ////////////
+
+//Registra la funcion de la biblioteca que se ejecutara al entregar los
+//avisos. Con NULL se dejan de entregar
+int sis_registrar_avisos() {
+
+	void *entrada = (void *)leer_registro(1);
+
+	if ((entrada != NULL) && (p_proc_actual->pila_avisos == NULL))
+		p_proc_actual->pila_avisos = crear_pila(TAM_PILA_AVISOS);
+
+	p_proc_actual->entrada_avisos = entrada;
+	return 0;
+}
+
+//Envia los avisos indicados por los bits a un proceso
+int sis_notificar() {
+
+	int pid = (int)leer_registro(1);
+	int avisos = (int)leer_registro(2);
+
+	BCP *dest = buscar_proceso(pid);
+
+	if ((dest == NULL) || (avisos == 0) || (avisos & AVISO_ALARMA)) {
+
+		printk("Destino o avisos no validos. ERROR\n");
+		return -1;
+	}
+
+	anotar_avisos(dest, avisos);
+	return 0;
+}
+
+//Bloquea al proceso hasta que tenga algun aviso pendiente
+int sis_esperar_avisos() {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	if (p_proc_actual->avisos_pendientes == 0)
+		bloquear_proceso(&lista_espera_avisos);
+
+	fijar_nivel_int(nivel);
+	return 0;
+}
+
+//Programa un AVISO_ALARMA dentro de ms milisegundos (0 la cancela)
+int sis_alarma_aviso() {
+
+	int ms = (int)leer_registro(1);
+
+	if (ms < 0)
+		return -1;
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	quitar_alarma(p_proc_actual);
+	p_proc_actual->ticks_alarma = (ms * TICK + 999) / 1000;
+
+	if (p_proc_actual->ticks_alarma > 0) {
+
+		p_proc_actual->siguiente_alarma = procs_alarma;
+		procs_alarma = p_proc_actual;
+	}
+
+	fijar_nivel_int(nivel);
+	return 0;
+}
+
+//Devuelve y borra todos los avisos pendientes
+int sis_tomar_avisos() {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+	int avisos = p_proc_actual->avisos_pendientes;
+
+	p_proc_actual->avisos_pendientes = 0;
+
+	fijar_nivel_int(nivel);
+	return avisos;
+}
+
+//Termina la ejecucion del manejador: se abandona su contexto y se sigue
+//por donde se interrumpio al proceso
+int sis_fin_avisos() {
+
+	if (!p_proc_actual->en_manejador)
+		return -1;
+
+	p_proc_actual->en_manejador = 0;
+	cambio_contexto(NULL, &(p_proc_actual->contexto_interrumpido));
+
+	return 0; /* no deberia llegar aqui */
+}
+
+//////////////
+// FICHEROS //
+//////////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Deja el sistema de ficheros con solo el directorio raiz
+static void iniciar_ficheros() {
+
+	array_inodos[0].tipo = INODO_DIRECTORIO;
+	strcpy(array_inodos[0].nombre, "/");
+	array_inodos[0].padre = 0;
+
+	for (int i = 0; i < NUM_FICH_ABIERTOS; i++)
+		array_fich_abiertos[i].inodo = -1;
+}
+
+//Busca una entrada dentro de un directorio
+static int buscar_en_directorio(int dir, char *nombre) {
+
+	for (int i = 1; i < NUM_INODOS; i++)
+		if ((array_inodos[i].tipo != INODO_LIBRE) && (array_inodos[i].padre == dir) &&
+			(strcmp(array_inodos[i].nombre, nombre) == 0))
+			return i;
+
+	return -1;
+}
+
+//Indica si un directorio no contiene ninguna entrada
+static int directorio_vacio(int dir) {
+
+	for (int i = 1; i < NUM_INODOS; i++)
+		if ((array_inodos[i].tipo != INODO_LIBRE) && (array_inodos[i].padre == dir))
+			return 0;
+
+	return 1;
+}
+
+//Recorre una ruta absoluta. Devuelve el inodo del directorio que contiene
+//el ultimo componente y deja este en ultimo, o -1 si algun directorio
+//intermedio no existe o algun componente es demasiado largo
+static int resolver_ruta(char *ruta, char *ultimo) {
+
+	int dir = 0;
+
+	while (*ruta == '/')
+		ruta++;
+
+	while (1) {
+
+		char *fin = strchr(ruta, '/');
+		int lon = (fin == NULL) ? strlen(ruta) : fin - ruta;
+
+		if (lon > MAX_NOM_FICH)
+			return -1;
+
+		strncpy(ultimo, ruta, lon);
+		ultimo[lon] = '\0';
+
+		//Se ignoran las barras finales
+		while ((fin != NULL) && (*fin == '/'))
+			fin++;
+		if ((fin == NULL) || (*fin == '\0'))
+			return dir;
+
+		dir = buscar_en_directorio(dir, ultimo);
+		if ((dir == -1) || (array_inodos[dir].tipo != INODO_DIRECTORIO))
+			return -1;
+
+		ruta = fin;
+	}
+}
+
+//Crea una entrada en un directorio
+static int crear_inodo(int dir, char *nombre, int tipo) {
+
+	int id;
+
+	for (id = 1; (id < NUM_INODOS) && (array_inodos[id].tipo != INODO_LIBRE); id++);
+	if (id == NUM_INODOS) {
+
+		printk("No quedan inodos libres. ERROR\n");
+		return -1;
+	}
+
+	inodo *ino = &array_inodos[id];
+	ino->tipo = tipo;
+	strcpy(ino->nombre, nombre);
+	ino->padre = dir;
+	ino->tam = 0;
+	ino->abierto = 0;
+	return id;
+}
+
+//Libera las paginas a partir de la que contiene el byte tam
+static void recortar_fichero(inodo *ino, int tam) {
+
+	for (int i = (tam + TAM_PAGINA - 1) / TAM_PAGINA; i < MAX_PAG_FICHERO; i++)
+		if (ino->paginas[i] != NULL) {
+
+			free(ino->paginas[i]);
+			ino->paginas[i] = NULL;
+		}
+
+	ino->tam = tam;
+}
+
+//Libera un inodo sin aperturas que ya no esta en ningun directorio
+static void liberar_inodo(int id) {
+
+	recortar_fichero(&array_inodos[id], 0);
+	array_inodos[id].tipo = INODO_LIBRE;
+}
+
+static fichero_abierto *fichero_de_descriptor(unsigned int descriptor) {
+
+	int id = objeto_de_descriptor(descriptor, DESC_FICHERO);
+
+	if (id < 0)
+		return NULL;
+
+	return &array_fich_abiertos[id];
+}
+
+int cerrar_descriptor_fichero(unsigned int descriptor) {
+
+	fichero_abierto *f = fichero_de_descriptor(descriptor);
+
+	if (f == NULL) {
+
+		printk("El descriptor del fichero no existe. ERROR\n");
+		return -1;
+	}
+
+	inodo *ino = &array_inodos[f->inodo];
+	ino->abierto--;
+	if ((ino->abierto == 0) && (ino->padre == -1))
+		liberar_inodo(f->inodo);
+
+	f->inodo = -1;
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	return 0;
+}
+
+////////// LLAMADAS ////////////
+
+//Abre un fichero con los modos F_LECTURA, F_ESCRITURA, F_CREAR y F_TRUNCAR
+int sis_abrir() {
+
+	char *ruta = (char *)leer_registro(1);
+	int modo = (int)leer_registro(2);
+	char nombre[MAX_NOM_FICH+1];
+	int dir, id, ab;
+
+	if ((modo & (F_LECTURA | F_ESCRITURA)) == 0) {
+
+		printk("Modo de apertura no valido. ERROR\n");
+		return -1;
+	}
+
+	if ((dir = resolver_ruta(ruta, nombre)) == -1) {
+
+		printk("Ruta %s no valida. ERROR\n", ruta);
+		return -1;
+	}
+
+	for (ab = 0; (ab < NUM_FICH_ABIERTOS) && (array_fich_abiertos[ab].inodo != -1); ab++);
+	if (ab == NUM_FICH_ABIERTOS) {
+
+		printk("Alcanzado el maximo de ficheros abiertos. ERROR\n");
+		return -1;
+	}
+
+	if (descriptor_libre() == -1) {
+
+		printk("El proceso no tiene descriptores libres. ERROR\n");
+		return -1;
+	}
+
+	id = buscar_en_directorio(dir, nombre);
+	if (id == -1) {
+
+		if (!(modo & F_CREAR) || (nombre[0] == '\0')) {
+
+			printk("No existe el fichero %s. ERROR\n", ruta);
+			return -1;
+		}
+
+		if ((id = crear_inodo(dir, nombre, INODO_FICHERO)) == -1)
+			return -1;
+	}
+	else if (array_inodos[id].tipo != INODO_FICHERO) {
+
+		printk("%s es un directorio. ERROR\n", ruta);
+		return -1;
+	}
+
+	if ((modo & F_TRUNCAR) && (modo & F_ESCRITURA))
+		recortar_fichero(&array_inodos[id], 0);
+
+	array_inodos[id].abierto++;
+	array_fich_abiertos[ab].inodo = id;
+	array_fich_abiertos[ab].modo = modo;
+	array_fich_abiertos[ab].posicion = 0;
+
+	return asignar_descriptor(DESC_FICHERO, ab);
+}
+
+//Lee desde la posicion actual. Los datos se copian directamente de cada
+//pagina al buffer del usuario y los huecos sin paginas se leen como ceros
+int sis_leer_fichero() {
+
+	fichero_abierto *f = fichero_de_descriptor((unsigned int)leer_registro(1));
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	int leidos = 0;
+
+	if ((f == NULL) || !(f->modo & F_LECTURA) || (tam < 0)) {
+
+		printk("Descriptor de fichero no valido para leer. ERROR\n");
+		return -1;
+	}
+
+	inodo *ino = &array_inodos[f->inodo];
+
+	if (tam > ino->tam - f->posicion)
+		tam = (ino->tam > f->posicion) ? ino->tam - f->posicion : 0;
+
+	while (leidos < tam) {
+
+		int pag = f->posicion / TAM_PAGINA;
+		int desp = f->posicion % TAM_PAGINA;
+		int n = TAM_PAGINA - desp;
+
+		if (n > tam - leidos)
+			n = tam - leidos;
+
+		if (ino->paginas[pag] != NULL)
+			copiar_parametro(buf + leidos, ino->paginas[pag] + desp, n);
+		else {
+
+			int nivel = fijar_nivel_int(NIVEL_3);
+			acceso_parametro = 1;
+			memset(buf + leidos, 0, n);
+			acceso_parametro = 0;
+			fijar_nivel_int(nivel);
+		}
+
+		leidos += n;
+		f->posicion += n;
+	}
+
+	return leidos;
+}
+
+//Escribe en la posicion actual reservando las paginas que falten
+int sis_escribir_fichero() {
+
+	fichero_abierto *f = fichero_de_descriptor((unsigned int)leer_registro(1));
+	char *buf = (char *)leer_registro(2);
+	int tam = (int)leer_registro(3);
+	int escritos = 0;
+
+	if ((f == NULL) || !(f->modo & F_ESCRITURA) || (tam < 0)) {
+
+		printk("Descriptor de fichero no valido para escribir. ERROR\n");
+		return -1;
+	}
+
+	inodo *ino = &array_inodos[f->inodo];
+
+	if (tam > MAX_PAG_FICHERO * TAM_PAGINA - f->posicion)
+		tam = MAX_PAG_FICHERO * TAM_PAGINA - f->posicion;
+
+	while (escritos < tam) {
+
+		int pag = f->posicion / TAM_PAGINA;
+		int desp = f->posicion % TAM_PAGINA;
+		int n = TAM_PAGINA - desp;
+
+		if (n > tam - escritos)
+			n = tam - escritos;
+
+		if (ino->paginas[pag] == NULL) {
+
+			ino->paginas[pag] = aligned_alloc(TAM_PAGINA, TAM_PAGINA);
+			if (ino->paginas[pag] == NULL) {
+
+				printk("No hay memoria para el fichero. ERROR\n");
+				break;
+			}
+			memset(ino->paginas[pag], 0, TAM_PAGINA);
+		}
+
+		copiar_parametro(ino->paginas[pag] + desp, buf + escritos, n);
+
+		escritos += n;
+		f->posicion += n;
+		if (f->posicion > ino->tam)
+			ino->tam = f->posicion;
+	}
+
+	return escritos;
+}
+
+//Cambia la posicion de un fichero abierto y la devuelve
+int sis_posicionar() {
+
+	fichero_abierto *f = fichero_de_descriptor((unsigned int)leer_registro(1));
+	int desp = (int)leer_registro(2);
+	int origen = (int)leer_registro(3);
+	int pos;
+
+	if (f == NULL) {
+
+		printk("El descriptor del fichero no existe. ERROR\n");
+		return -1;
+	}
+
+	switch (origen) {
+		case DESDE_INICIO:
+			pos = desp;
+			break;
+		case DESDE_ACTUAL:
+			pos = f->posicion + desp;
+			break;
+		case DESDE_FINAL:
+			pos = array_inodos[f->inodo].tam + desp;
+			break;
+		default:
+			pos = -1;
+	}
+
+	if ((pos < 0) || (pos > MAX_PAG_FICHERO * TAM_PAGINA)) {
+
+		printk("Posicion no valida. ERROR\n");
+		return -1;
+	}
+
+	f->posicion = pos;
+	return pos;
+}
+
+int sis_cerrar_fichero() {
+
+	return cerrar_descriptor_fichero((unsigned int)leer_registro(1));
+}
+
+int sis_crear_directorio() {
+
+	char *ruta = (char *)leer_registro(1);
+	char nombre[MAX_NOM_FICH+1];
+	int dir;
+
+	if (((dir = resolver_ruta(ruta, nombre)) == -1) || (nombre[0] == '\0')) {
+
+		printk("Ruta %s no valida. ERROR\n", ruta);
+		return -1;
+	}
+
+	if (buscar_en_directorio(dir, nombre) != -1) {
+
+		printk("Ya existe %s. ERROR\n", ruta);
+		return -1;
+	}
+
+	return (crear_inodo(dir, nombre, INODO_DIRECTORIO) == -1) ? -1 : 0;
+}
+
+//Borra un fichero o un directorio vacio. Un fichero abierto desaparece
+//del directorio pero su contenido se libera con el ultimo cierre
+int sis_borrar() {
+
+	char *ruta = (char *)leer_registro(1);
+	char nombre[MAX_NOM_FICH+1];
+	int dir, id;
+
+	if (((dir = resolver_ruta(ruta, nombre)) == -1) ||
+		((id = buscar_en_directorio(dir, nombre)) == -1)) {
+
+		printk("No existe %s. ERROR\n", ruta);
+		return -1;
+	}
+
+	if ((array_inodos[id].tipo == INODO_DIRECTORIO) && !directorio_vacio(id)) {
+
+		printk("El directorio %s no esta vacio. ERROR\n", ruta);
+		return -1;
+	}
+
+	array_inodos[id].padre = -1;
+	if (array_inodos[id].abierto == 0)
+		liberar_inodo(id);
+
+	return 0;
+}
+
+///////////
+// DISCO //
+///////////
+
+//El disco es un fichero del anfitrion. Un hilo del anfitrion, con todas las
+//senales bloqueadas, atiende las peticiones que le deja el kernel en una
+//cola y, al terminar alguna, activa la linea de interrupcion del disco: le
+//manda SIGURG, que el HAL no usa, hasta que int_disco la desactiva. La senal
+//solo sirve para despertar a halt; las operaciones terminadas se completan
+//en int_disco, que se invoca en cada tick y cada vez que se sale de espera_int
+
+//////// FUNCIONES AUXILIARES //////////
+
+#define REPETICION_INT_DISCO 200000 /* ns entre senales mientras siga activa */
+
+static int fd_disco = -1;
+static pthread_t hilo_disco;
+static pthread_mutex_t mutex_disco = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond_disco = PTHREAD_COND_INITIALIZER;
+static volatile int linea_disco; //Hay operaciones terminadas sin completar
+
+//Cola de buffers con una operacion pendiente (cada uno a lo sumo una vez)
+static int cola_disco[MAX_BUFFERS];
+static int primera_peticion, num_peticiones;
+
+static int ultimo_bloque_leido = -1;
+static int ticks_volcado = TICKS_VOLCADO;
+
+static void *servidor_disco(void *arg) {
+
+	struct timespec limite;
+
+	pthread_mutex_lock(&mutex_disco);
+
+	while (1) {
+
+		//Si la senal llega justo antes de que halt se duerma se perderia:
+		//se repite mientras el kernel no haya atendido la interrupcion
+		while (num_peticiones == 0) {
+
+			if (!__atomic_load_n(&linea_disco, __ATOMIC_ACQUIRE)) {
+
+				pthread_cond_wait(&cond_disco, &mutex_disco);
+				continue;
+			}
+
+			kill(getpid(), SIGURG);
+			clock_gettime(CLOCK_REALTIME, &limite);
+			limite.tv_nsec += REPETICION_INT_DISCO;
+			if (limite.tv_nsec >= 1000000000) {
+
+				limite.tv_sec++;
+				limite.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&cond_disco, &mutex_disco, &limite);
+		}
+
+		buffer *b = &array_buffers[cola_disco[primera_peticion]];
+		primera_peticion = (primera_peticion + 1) % MAX_BUFFERS;
+		num_peticiones--;
+		pthread_mutex_unlock(&mutex_disco);
+
+		off_t desp = (off_t)b->bloque * TAM_BLOQUE;
+		ssize_t hechos;
+		if (b->escribiendo)
+			hechos = pwrite(fd_disco, b->datos, TAM_BLOQUE, desp);
+		else
+			hechos = pread(fd_disco, b->datos, TAM_BLOQUE, desp);
+		b->error = (hechos != TAM_BLOQUE);
+
+		__atomic_store_n(&b->terminada, 1, __ATOMIC_RELEASE);
+		__atomic_store_n(&linea_disco, 1, __ATOMIC_RELEASE);
+		kill(getpid(), SIGURG);
+
+		pthread_mutex_lock(&mutex_disco);
+	}
+
+	return NULL;
+}
+
+static void despertar_halt(int senal) {
+}
+
+//Abre el fichero del disco, creandolo si no existe, la primera vez que
+//hay que acceder a el: si ningun programa usa el disco no se crea.
+//Devuelve -1 si no se puede
+static int abrir_disco() {
+
+	if (fd_disco >= 0)
+		return 0;
+
+	fd_disco = open(FICHERO_DISCO, O_RDWR | O_CREAT, 0644);
+	if ((fd_disco >= 0) && (ftruncate(fd_disco, (off_t)NUM_BLOQUES * TAM_BLOQUE) < 0)) {
+
+		close(fd_disco);
+		fd_disco = -1;
+	}
+
+	if (fd_disco < 0) {
+
+		printk("No se puede crear el fichero del disco %s. ERROR\n", FICHERO_DISCO);
+		return -1;
+	}
+	return 0;
+}
+
+//Prepara la cache y arranca el hilo que atiende el disco
+void iniciar_disco() {
+
+	struct sigaction act;
+	sigset_t todas, previas;
+
+	for (int i = 0; i < MAX_BUFFERS; i++) {
+
+		array_buffers[i].bloque = -1;
+		array_buffers[i].datos = malloc(TAM_BLOQUE);
+	}
+	num_buffers = BUFFERS_INICIALES;
+
+	act.sa_handler = despertar_halt;
+	act.sa_flags = SA_RESTART;
+	sigemptyset(&act.sa_mask);
+	sigaction(SIGURG, &act, NULL);
+
+	//El hilo hereda la mascara: no debe recibir ninguna interrupcion
+	sigfillset(&todas);
+	pthread_sigmask(SIG_BLOCK, &todas, &previas);
+	if (pthread_create(&hilo_disco, NULL, servidor_disco, NULL) != 0)
+		panico("no se puede crear el hilo del disco");
+	pthread_sigmask(SIG_SETMASK, &previas, NULL);
+}
+
+//Entrega una operacion al hilo del anfitrion. Si no se puede abrir el
+//disco la operacion falla sin llegar a lanzarse
+static void lanzar_operacion(buffer *b, int escribir) {
+
+	if (abrir_disco() < 0) {
+
+		b->estado |= BUF_ERROR;
+		return;
+	}
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	b->estado = (b->estado & ~BUF_ERROR) | BUF_EN_ES;
+	b->escribiendo = escribir;
+	b->terminada = 0;
+
+	if (escribir)
+		estadisticas_disco.escrituras++;
+	else
+		estadisticas_disco.lecturas++;
+
+	pthread_mutex_lock(&mutex_disco);
+	cola_disco[(primera_peticion + num_peticiones) % MAX_BUFFERS] = b - array_buffers;
+	num_peticiones++;
+	pthread_cond_signal(&cond_disco);
+	pthread_mutex_unlock(&mutex_disco);
+
+	fijar_nivel_int(nivel);
+}
+
+//Bloquea al proceso actual hasta que termine la operacion del buffer
+static void esperar_buffer(buffer *b) {
+
+	//Sin interrupciones para que int_disco no la complete entre medias
+	int nivel = fijar_nivel_int(NIVEL_3);
+	int inicio = num_ticks;
+
+	if (b->estado & BUF_EN_ES)
+		bloquear_proceso(&b->lista_esperando);
+
+	estadisticas_disco.ticks_espera += num_ticks - inicio;
+	fijar_nivel_int(nivel);
+}
+
+//Completa las operaciones que el hilo del anfitrion ha terminado
+void int_disco() {
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	__atomic_store_n(&linea_disco, 0, __ATOMIC_RELEASE);
+
+	for (int i = 0; i < MAX_BUFFERS; i++) {
+
+		buffer *b = &array_buffers[i];
+
+		if (!(b->estado & BUF_EN_ES) || !__atomic_load_n(&b->terminada, __ATOMIC_ACQUIRE))
+			continue;
+
+		//Si falla, el bloque sigue sin leer o pendiente de escribir
+		b->estado &= ~BUF_EN_ES;
+		if (b->error)
+			b->estado |= BUF_ERROR;
+		else if (b->escribiendo)
+			b->estado &= ~BUF_SUCIO;
+		else
+			b->estado |= BUF_VALIDO;
+
+		desbloquear_todos(&b->lista_esperando);
+	}
+
+	fijar_nivel_int(nivel);
+}
+
+//Escritura diferida periodica de los bloques modificados. Se invoca desde int_reloj
+void cuentaAtrasVolcado() {
+
+	if (--ticks_volcado > 0)
+		return;
+
+	ticks_volcado = TICKS_VOLCADO;
+	for (int i = 0; i < num_buffers; i++)
+		if ((array_buffers[i].estado & (BUF_SUCIO | BUF_EN_ES)) == BUF_SUCIO)
+			lanzar_operacion(&array_buffers[i], 1);
+}
+
+//Escribe sincronamente todos los bloques modificados. Se usa al apagar el
+//sistema, cuando ya no queda ningun proceso al que bloquear
+void volcar_disco() {
+
+	int sucios = 0;
+
+	for (int i = 0; i < MAX_BUFFERS; i++)
+		if (array_buffers[i].estado & BUF_SUCIO)
+			sucios = 1;
+	if (!sucios || (abrir_disco() < 0))
+		return;
+
+	for (int i = 0; i < MAX_BUFFERS; i++) {
+
+		buffer *b = &array_buffers[i];
+
+		while ((b->estado & BUF_EN_ES) && !__atomic_load_n(&b->terminada, __ATOMIC_ACQUIRE))
+			sched_yield();
+
+		if ((b->estado & BUF_SUCIO) && !(b->escribiendo && (b->estado & BUF_EN_ES)) &&
+			(pwrite(fd_disco, b->datos, TAM_BLOQUE, (off_t)b->bloque * TAM_BLOQUE) != TAM_BLOQUE))
+			printk("No se ha podido escribir el bloque %d en el disco. ERROR\n", b->bloque);
+	}
+
+	fsync(fd_disco);
+}
+
+static buffer *buscar_buffer(int bloque) {
+
+	for (int i = 0; i < num_buffers; i++)
+		if (array_buffers[i].bloque == bloque)
+			return &array_buffers[i];
+
+	return NULL;
+}
+
+//Victima LRU entre los buffers sin operaciones pendientes
+static buffer *buscar_victima(int solo_limpios) {
+
+	buffer *victima = NULL;
+
+	for (int i = 0; i < num_buffers; i++) {
+
+		buffer *b = &array_buffers[i];
+
+		if ((b->estado & BUF_EN_ES) || (solo_limpios && (b->estado & BUF_SUCIO)))
+			continue;
+
+		if ((victima == NULL) || (b->ultimo_uso < victima->ultimo_uso))
+			victima = b;
+	}
+
+	return victima;
+}
+
+//Devuelve el buffer del bloque, sin operaciones pendientes y, si leer es
+//cierto, con sus datos validos. Puede bloquear al proceso varias veces.
+//Devuelve NULL si falla la escritura de la victima o, dos veces, la lectura
+static buffer *obtener_buffer(int bloque, int leer) {
+
+	int fallo = 0, reintentado = 0;
+	buffer *b;
+
+	while (1) {
+
+		b = buscar_buffer(bloque);
+
+		if (b == NULL) {
+
+			fallo = 1;
+			b = buscar_victima(0);
+
+			//Todos ocupados: se espera a que termine cualquiera
+			if (b == NULL) {
+
+				esperar_buffer(&array_buffers[0]);
+				continue;
+			}
+
+			if (b->estado & BUF_SUCIO) {
+
+				lanzar_operacion(b, 1);
+				esperar_buffer(b);
+				if (b->estado & BUF_ERROR)
+					return NULL;
+				continue;
+			}
+
+			b->bloque = bloque;
+			b->estado = 0;
+			b->adelantado = 0;
+
+			if (!leer)
+				break;
+
+			lanzar_operacion(b, 0);
+		}
+
+		if (b->estado & BUF_EN_ES) {
+
+			fallo = 1;
+			esperar_buffer(b);
+			continue;
+		}
+
+		if (!leer || (b->estado & BUF_VALIDO))
+			break;
+
+		if (b->estado & BUF_ERROR) {
+
+			if (reintentado)
+				return NULL;
+			reintentado = 1;
+		}
+
+		fallo = 1;
+		lanzar_operacion(b, 0);
+	}
+
+	if (fallo)
+		estadisticas_disco.fallos++;
+	else
+		estadisticas_disco.aciertos++;
+
+	b->adelantado = 0;
+	b->ultimo_uso = ++reloj_lru;
+	return b;
+}
+
+//En accesos secuenciales pide los siguientes bloques sin esperar por ellos.
+//Solo reutiliza buffers limpios y nunca mas de la cuarta parte de la cache
+static void leer_adelantado(int bloque) {
+
+	int n = BLOQUES_ADELANTADOS;
+
+	if (n > num_buffers / 4)
+		n = num_buffers / 4;
+
+	for (int i = 1; (i <= n) && (bloque + i < NUM_BLOQUES); i++) {
+
+		if (buscar_buffer(bloque + i) != NULL)
+			continue;
+
+		buffer *b = buscar_victima(1);
+		if ((b == NULL) || b->adelantado)
+			return;
+
+		b->bloque = bloque + i;
+		b->estado = 0;
+		b->adelantado = 1;
+		b->ultimo_uso = ++reloj_lru;
+		estadisticas_disco.adelantadas++;
+		lanzar_operacion(b, 0);
+	}
+}
+
+////////// LLAMADAS ////////////
+
+int sis_leer_bloque() {
+
+	int bloque = (int)leer_registro(1);
+	char *buf = (char *)leer_registro(2);
+
+	if ((bloque < 0) || (bloque >= NUM_BLOQUES)) {
+
+		printk("Bloque %d fuera del disco. ERROR\n", bloque);
+		return -1;
+	}
+
+	buffer *b = obtener_buffer(bloque, 1);
+	if (b == NULL) {
+
+		printk("No se ha podido leer el bloque %d del disco. ERROR\n", bloque);
+		return -1;
+	}
+	copiar_parametro(buf, b->datos, TAM_BLOQUE);
+
+	if (bloque == ultimo_bloque_leido + 1)
+		leer_adelantado(bloque);
+	ultimo_bloque_leido = bloque;
+
+	return 0;
+}
+
+//Escribe un bloque completo: no hace falta leerlo antes. El bloque queda
+//en la cache y llega al disco al expulsarlo, periodicamente o al sincronizar
+int sis_escribir_bloque() {
+
+	int bloque = (int)leer_registro(1);
+	char *buf = (char *)leer_registro(2);
+
+	if ((bloque < 0) || (bloque >= NUM_BLOQUES)) {
+
+		printk("Bloque %d fuera del disco. ERROR\n", bloque);
+		return -1;
+	}
+
+	buffer *b;
+	int nivel;
+
+	//Sin interrupciones desde que el buffer no tiene operaciones hasta
+	//que queda sucio: el volcado periodico no puede lanzar su escritura
+	//mientras se copia, ni int_disco limpiarlo despues
+	while (1) {
+
+		b = obtener_buffer(bloque, 0);
+		if (b == NULL) {
+
+			printk("No se ha podido liberar un buffer de la cache. ERROR\n");
+			return -1;
+		}
+
+		nivel = fijar_nivel_int(NIVEL_3);
+		if (!(b->estado & BUF_EN_ES))
+			break;
+		fijar_nivel_int(nivel);
+
+		//Mientras se espera el buffer puede pasar a otro bloque
+		esperar_buffer(b);
+	}
+
+	copiar_parametro(b->datos, buf, TAM_BLOQUE);
+	b->estado |= BUF_VALIDO | BUF_SUCIO;
+	fijar_nivel_int(nivel);
+
+	return 0;
+}
+
+//Escribe los bloques modificados y espera a que esten en el disco. Falla
+//si alguno no se ha podido escribir
+int sis_sincronizar() {
+
+	int error = 0;
+
+	for (int i = 0; i < num_buffers; i++)
+		if ((array_buffers[i].estado & (BUF_SUCIO | BUF_EN_ES)) == BUF_SUCIO)
+			lanzar_operacion(&array_buffers[i], 1);
+
+	for (int i = 0; i < num_buffers; i++) {
+
+		buffer *b = &array_buffers[i];
+
+		while (b->estado & BUF_EN_ES)
+			esperar_buffer(b);
+		if ((b->estado & (BUF_SUCIO | BUF_ERROR)) == (BUF_SUCIO | BUF_ERROR))
+			error = 1;
+	}
+
+	if (error) {
+
+		printk("No se han podido escribir todos los bloques en el disco. ERROR\n");
+		return -1;
+	}
+	return 0;
+}
+
+//Cambia el numero de buffers de la cache. La cache queda vacia, con todos
+//los bloques modificados ya escritos en el disco
+int sis_ajustar_cache() {
+
+	int n = (int)leer_registro(1);
+
+	if ((n < 1) || (n > MAX_BUFFERS)) {
+
+		printk("Tamano de cache no valido (1-%d). ERROR\n", MAX_BUFFERS);
+		return -1;
+	}
+
+	//No se pierden los bloques que no se han podido escribir
+	if (sis_sincronizar() < 0)
+		return -1;
+
+	for (int i = 0; i < MAX_BUFFERS; i++) {
+
+		array_buffers[i].bloque = -1;
+		array_buffers[i].estado = 0;
+		array_buffers[i].adelantado = 0;
+	}
+
+	num_buffers = n;
+	ultimo_bloque_leido = -1;
+	return 0;
+}
+
+//Copia las estadisticas acumuladas y las pone a cero
+int sis_estadisticas_disco() {
+
+	struct estad_disco *estad = (struct estad_disco *)leer_registro(1);
+
+	if (estad != NULL)
+		copiar_parametro(estad, &estadisticas_disco, sizeof(struct estad_disco));
+
+	memset(&estadisticas_disco, 0, sizeof(struct estad_disco));
+	return 0;
+}
+
+////////////////////////////
+// REGIONES TRANSFERIBLES //
+////////////////////////////
+
+//Una region es un conjunto de paginas que solo puede usar su propietario.
+//Como todos los procesos comparten el espacio de direcciones, el kernel
+//quita el acceso a las paginas (mprotect) a quien no es su propietario cada
+//vez que cambia el proceso en ejecucion. Transferir una region solo cambia
+//su propietario: los datos nunca se copian
+
+//////// FUNCIONES AUXILIARES //////////
+
+static unsigned int orden_regiones; //Para entregar las regiones en orden
+
+//Da acceso a las regiones de proc y se lo quita a las demas. Solo cambia
+//la proteccion de las que la tienen distinta de la que les corresponde
+void proteger_regiones(BCP *proc) {
+
+	for (int i = 0; i < NUM_REGIONES; i++) {
+
+		region *r = &array_regiones[i];
+		int accesible = (r->dir != NULL) && (r->propietario == proc->id);
+
+		if ((r->dir != NULL) && (r->accesible != accesible)) {
+
+			mprotect(r->dir, r->tam, accesible ? PROT_READ | PROT_WRITE : PROT_NONE);
+			r->accesible = accesible;
+		}
+	}
+}
+
+static void liberar_region(int id) {
+
+	munmap(array_regiones[id].dir, array_regiones[id].tam);
+	array_regiones[id].dir = NULL;
+}
+
+int cerrar_descriptor_region(unsigned int descriptor) {
+
+	int id = objeto_de_descriptor(descriptor, DESC_REGION);
+
+	if (id < 0) {
+
+		printk("El descriptor de la region no existe. ERROR\n");
+		return -1;
+	}
+
+	p_proc_actual->descriptores[descriptor].tipo = DESC_LIBRE;
+	liberar_region(id);
+	return 0;
+}
+
+//Libera las regiones que se estaban transfiriendo al proceso actual y que
+//ya no podra recibir. Las que son suyas las libera cerrar_descriptores
+void cancelar_regiones() {
+
+	for (int i = 0; i < NUM_REGIONES; i++)
+		if ((array_regiones[i].dir != NULL) && (array_regiones[i].destino == p_proc_actual->id))
+			liberar_region(i);
+}
+
+//Region pendiente de recibir por el proceso actual mas antigua o -1
+static int region_pendiente() {
+
+	int id = -1;
+
+	for (int i = 0; i < NUM_REGIONES; i++)
+		if ((array_regiones[i].dir != NULL) && (array_regiones[i].destino == p_proc_actual->id) &&
+			((id == -1) || (array_regiones[i].orden < array_regiones[id].orden)))
+			id = i;
+
+	return id;
+}
+
+////////// LLAMADAS ////////////
+
+//Crea una region de al menos tam bytes (se redondea a paginas) a cero.
+//Devuelve el descriptor y en *dir su direccion, alineada a pagina
+int sis_crear_region() {
+
+	int tam = (int)leer_registro(1);
+	void **dir = (void **)leer_registro(2);
+	int id;
+
+	if (tam <= 0) {
+
+		printk("Tamano de la region no valido. ERROR\n");
+		return -1;
+	}
+
+	for (id = 0; (id < NUM_REGIONES) && (array_regiones[id].dir != NULL); id++);
+	if (id == NUM_REGIONES) {
+
+		printk("Alcanzado el maximo de regiones creadas. ERROR\n");
+		return -1;
+	}
+
+	tam = (tam + TAM_PAGINA - 1) / TAM_PAGINA * TAM_PAGINA;
+	void *zona = mmap(NULL, tam, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (zona == MAP_FAILED) {
+
+		printk("No hay memoria para la region. ERROR\n");
+		return -1;
+	}
+
+	array_regiones[id].dir = zona;
+	array_regiones[id].tam = tam;
+	array_regiones[id].propietario = p_proc_actual->id;
+	array_regiones[id].destino = -1;
+	array_regiones[id].accesible = 1;
+
+	int nuevo_des = asignar_descriptor(DESC_REGION, id);
+	if (nuevo_des == -1) {
+
+		liberar_region(id);
+		return -1;
+	}
+
+	copiar_parametro(dir, &zona, sizeof(zona));
+	return nuevo_des;
+}
+
+//Cede la region al proceso pid. El descriptor se cierra y el proceso
+//actual deja de poder acceder a la region inmediatamente
+int sis_transferir_region() {
+
+	unsigned int des = (unsigned int)leer_registro(1);
+	int pid = (int)leer_registro(2);
+	int id = objeto_de_descriptor(des, DESC_REGION);
+
+	if ((id < 0) || !pid_valido(pid)) {
+
+		printk("Descriptor de region o proceso destino no validos. ERROR\n");
+		return -1;
+	}
+
+	region *r = &array_regiones[id];
+
+	p_proc_actual->descriptores[des].tipo = DESC_LIBRE;
+	r->propietario = -1;
+	r->destino = pid;
+	r->origen = p_proc_actual->id;
+	r->orden = orden_regiones++;
+	proteger_regiones(p_proc_actual);
+
+	//El destino puede estar bloqueado esperando regiones
+	for (BCP *proc = lista_espera_regiones.primero; proc != NULL; proc = proc->siguiente)
+		if (proc->id == pid) {
+
+			int nivel = fijar_nivel_int(NIVEL_3);
+			eliminar_elem(&lista_espera_regiones, proc);
+			proc->estado = LISTO;
+			insertar_ultimo(&lista_listos, proc);
+			fijar_nivel_int(nivel);
+			break;
+		}
+
+	return 0;
+}
+
+//Espera a que otro proceso le transfiera una region. Devuelve el nuevo
+//descriptor, en *dir la direccion, en *tam el tamano y en *pid el origen
+int sis_recibir_region() {
+
+	void **dir = (void **)leer_registro(1);
+	int *tam = (int *)leer_registro(2);
+	int *pid = (int *)leer_registro(3);
+	int id;
+
+	if (descriptor_libre() == -1) {
+
+		printk("El proceso no tiene descriptores libres. ERROR\n");
+		return -1;
+	}
+
+	while ((id = region_pendiente()) == -1)
+		bloquear_proceso(&lista_espera_regiones);
+
+	region *r = &array_regiones[id];
+	int nuevo_des = asignar_descriptor(DESC_REGION, id);
+
+	r->propietario = p_proc_actual->id;
+	r->destino = -1;
+	proteger_regiones(p_proc_actual);
+
+	copiar_parametro(dir, &r->dir, sizeof(void *));
+	if (tam != NULL)
+		copiar_parametro(tam, &r->tam, sizeof(int));
+	if (pid != NULL)
+		copiar_parametro(pid, &r->origen, sizeof(int));
+
+	return nuevo_des;
+}
+
+int sis_liberar_region() {
+
+	return cerrar_descriptor_region((unsigned int)leer_registro(1));
+}
+
+//////////////////////////////
+// ESPERA DE PROCESOS HIJOS //
+//////////////////////////////
+
+//////// FUNCIONES AUXILIARES //////////
+
+//El hijo pid ha terminado: deja de contar para el padre, que se
+//despierta si lo estaba esperando
+static void completar_zombi(BCP *padre, int pid) {
+
+	padre->hijos_vivos--;
+
+	if (padre->esperando_hijo && ((padre->hijo_esperado == -1) || (padre->hijo_esperado == pid))) {
+
+		int nivel = fijar_nivel_int(NIVEL_3);
+
+		padre->esperando_hijo = 0;
+		eliminar_elem(&lista_espera_hijos, padre);
+		padre->estado = LISTO;
+		insertar_ultimo(&lista_listos, padre);
+
+		fijar_nivel_int(nivel);
+	}
+}
+
+//Deja el estado de salida del proceso actual a su padre como zombi. Si
+//termina el hilo inicial y quedan otros, el zombi queda pendiente con su
+//estado y lo completa el ultimo hilo. Si el padre ya ha terminado nadie
+//puede recoger el estado (los pids no se reutilizan)
+void dejar_zombi(int estado, int ultimo_hilo) {
+
+	grupo_hilos *g = p_proc_actual->grupo;
+
+	if (ultimo_hilo && (g != NULL) && (g->registro != NULL)) {
+
+		g->registro->grupo = NULL;
+		completar_zombi(buscar_proceso(g->padre), g->registro->pid);
+		g->registro = NULL;
+		return;
+	}
+
+	BCP *padre = buscar_proceso(p_proc_actual->padre);
+
+	if (padre == NULL)
+		return;
+
+	//Sin memoria el padre no podra recoger el estado, pero el proceso
+	//termina igual para el
+	zombi *z = malloc(sizeof(zombi));
+	zombi **fin;
+
+	if (z == NULL) {
+
+		printk("No hay memoria para el estado de salida del proceso %d. ERROR\n", p_proc_actual->id);
+		completar_zombi(padre, p_proc_actual->id);
+		return;
+	}
+
+	z->pid = p_proc_actual->id;
+	z->estado = estado;
+	z->grupo = NULL;
+	z->siguiente = NULL;
+
+	//Al final, para recogerlos en el orden en que terminan
+	for (fin = &padre->zombis; *fin != NULL; fin = &(*fin)->siguiente);
+	*fin = z;
+
+	if (!ultimo_hilo) {
+
+		z->grupo = g;
+		g->registro = z;
+		g->padre = padre->id;
+		return;
+	}
+
+	completar_zombi(padre, z->pid);
+}
+
+//Descarta los zombis que el proceso actual no ha recogido. Los de hijos
+//que siguen con otros hilos dejan de estar en el grupo de estos
+void liberar_zombis() {
+
+	zombi *z;
+
+	while ((z = p_proc_actual->zombis) != NULL) {
+
+		p_proc_actual->zombis = z->siguiente;
+		if (z->grupo != NULL)
+			z->grupo->registro = NULL;
+		free(z);
+	}
+}
+
+//Comprueba que pid es un hijo del proceso actual que no ha terminado,
+//aunque ya lo haya hecho su hilo inicial
+static int hijo_vivo(int pid) {
+
+	BCP *hijo = buscar_proceso(pid);
+
+	if (hijo != NULL)
+		return hijo->padre == p_proc_actual->id;
+
+	for (zombi *z = p_proc_actual->zombis; z != NULL; z = z->siguiente)
+		if ((z->pid == pid) && (z->grupo != NULL))
+			return 1;
+	return 0;
+}
+
+////////// LLAMADAS ////////////
+
+//Espera a que termine el hijo pid (-1 cualquiera). Devuelve su pid y en
+//*estado su estado de salida, que es -1 si lo aborto una excepcion
+int sis_esperar_proceso() {
+
+	int pid = (int)leer_registro(1);
+	int *estado = (int *)leer_registro(2);
+	BCP *yo = p_proc_actual;
+	zombi **z;
+
+	while (1) {
+
+		for (z = &yo->zombis; *z != NULL; z = &(*z)->siguiente)
+			if (((*z)->grupo == NULL) && ((pid == -1) || ((*z)->pid == pid))) {
+
+				zombi *encontrado = *z;
+				int res = encontrado->pid;
+
+				*z = encontrado->siguiente;
+				if (estado != NULL)
+					copiar_parametro(estado, &encontrado->estado, sizeof(int));
+				free(encontrado);
+				return res;
+			}
+
+		//Sin hijos esperar_hijo no es un error: asi acaban los bucles
+		//que recogen a todos
+		if ((pid == -1) && (yo->hijos_vivos == 0))
+			return -1;
+
+		if ((pid != -1) && !hijo_vivo(pid)) {
+
+			printk("No hay ningun hijo %d que esperar. ERROR\n", pid);
+			return -1;
+		}
+
+		yo->hijo_esperado = pid;
+		yo->esperando_hijo = 1;
+		bloquear_proceso(&lista_espera_hijos);
+	}
+}
+
+///////////////////////
+// CACHE DE IMAGENES //
+///////////////////////
+
+//Todas las instancias vivas de un programa comparten una unica imagen del
+//HAL y, cuando terminan, la imagen se conserva para las siguientes hasta
+//que se expulsa por LRU. El HAL llama a exit al liberar su ultima imagen,
+//asi que al terminar el ultimo proceso se vacia la cache entera
+
+//////// FUNCIONES AUXILIARES //////////
+
+static unsigned int reloj_imagenes;
+
+//Libera la imagen de una entrada sin procesos
+static void expulsar_imagen(imagen_cache *im) {
+
+	void *mem = im->mem;
+
+	im->mem = NULL;
+	liberar_imagen(mem);
+}
+
+//Expulsa las imagenes sin procesos menos usadas recientemente hasta que
+//queden como mucho max_imagenes_libres
+static void recortar_cache_imagenes() {
+
+	while (1) {
+
+		imagen_cache *victima = NULL;
+		int libres = 0;
+
+		for (int i = 0; i < NUM_IMAGENES; i++) {
+
+			imagen_cache *im = &array_imagenes[i];
+
+			if ((im->mem == NULL) || (im->refs > 0))
+				continue;
+
+			libres++;
+			if ((victima == NULL) || (im->ultimo_uso < victima->ultimo_uso))
+				victima = im;
+		}
+
+		if (libres <= max_imagenes_libres)
+			return;
+
+		expulsar_imagen(victima);
+	}
+}
+
+//Devuelve la imagen del programa para el proceso, de la cache si ya esta
+//cargada. Si la cache esta llena de imagenes en uso se carga sin guardarla
+void *obtener_imagen(BCP *proc, char *prog, void **pc) {
+
+	imagen_cache *libre = NULL;
+	void *mem;
+
+	proc->imagen = NULL;
+
+	if (strlen(prog) <= MAX_NOM_PROG)
+		for (int i = 0; i < NUM_IMAGENES; i++) {
+
+			imagen_cache *im = &array_imagenes[i];
+
+			if (im->mem == NULL) {
+
+				if (libre == NULL)
+					libre = im;
+			}
+			else if (strcmp(im->nombre, prog) == 0) {
+
+				im->refs++;
+				im->ultimo_uso = ++reloj_imagenes;
+				estadisticas_imagenes.aciertos++;
+				proc->imagen = im;
+				*pc = im->pc;
+				return im->mem;
+			}
+		}
+
+	estadisticas_imagenes.fallos++;
+
+	mem = crear_imagen(prog, pc);
+	if ((mem == NULL) || (strlen(prog) > MAX_NOM_PROG))
+		return mem;
+
+	//Sin entradas vacias se reutiliza la de la imagen libre mas antigua
+	if (libre == NULL) {
+
+		recortar_cache_imagenes();
+		for (int i = 0; (i < NUM_IMAGENES) && (libre == NULL); i++)
+			if (array_imagenes[i].mem == NULL)
+				libre = &array_imagenes[i];
+	}
+
+	if (libre != NULL) {
+
+		strcpy(libre->nombre, prog);
+		libre->mem = mem;
+		libre->pc = *pc;
+		libre->refs = 1;
+		libre->ultimo_uso = ++reloj_imagenes;
+		proc->imagen = libre;
+	}
+
+	return mem;
+}
+
+//Da al proceso la imagen de otro del mismo programa sin buscarla. NULL si
+//la del modelo no esta en la cache
+void *compartir_imagen(BCP *proc, BCP *modelo, void **pc) {
+
+	if (modelo->imagen == NULL)
+		return NULL;
+
+	proc->imagen = modelo->imagen;
+	proc->imagen->refs++;
+	estadisticas_imagenes.aciertos++;
+	*pc = proc->imagen->pc;
+	return proc->imagen->mem;
+}
+
+//Suelta la imagen de un proceso que termina. Si es el ultimo proceso
+//libera todas las imagenes: la ultima llamada a liberar_imagen no vuelve
+void soltar_imagen(BCP *proc, int ultimo_proceso) {
+
+	if (proc->imagen == NULL)
+		liberar_imagen(proc->info_mem);
+	else
+		proc->imagen->refs--;
+
+	if (ultimo_proceso)
+		max_imagenes_libres = 0;
+
+	recortar_cache_imagenes();
+}
+
+////////// LLAMADAS ////////////
+
+//Fija cuantas imagenes sin procesos se conservan (0 desactiva la cache)
+int sis_ajustar_cache_imagenes() {
+
+	int n = (int)leer_registro(1);
+
+	if ((n < 0) || (n > NUM_IMAGENES)) {
+
+		printk("Tamano de la cache de imagenes no valido (0-%d). ERROR\n", NUM_IMAGENES);
+		return -1;
+	}
+
+	max_imagenes_libres = n;
+	recortar_cache_imagenes();
+	return 0;
+}
+
+//Copia las estadisticas de la cache de imagenes y las pone a cero
+int sis_estadisticas_imagenes() {
+
+	struct estad_imagenes *estad = (struct estad_imagenes *)leer_registro(1);
+
+	if (estad != NULL)
+		copiar_parametro(estad, &estadisticas_imagenes, sizeof(struct estad_imagenes));
+
+	memset(&estadisticas_imagenes, 0, sizeof(struct estad_imagenes));
+	return 0;
+}
+
+//////////////////////
+// RESERVA DE PILAS //
+//////////////////////
+
+//Las pilas de los procesos que terminan se guardan para los siguientes en
+//vez de liberarlas, y conservan las paginas que ya se tocaron. Si no se
+//crean ni terminan procesos durante TICKS_RECORTE_PILAS, la reserva se
+//recorta hasta max_pilas_libres. Solo se guardan las de tamano TAM_PILA.
+//
+//Cada pila es una proyeccion anonima que solo reserva direcciones: las
+//paginas se asignan al tocarlas. Debajo lleva una pagina sin permisos,
+//por lo que un desbordamiento produce una excepcion de memoria en vez de
+//pisar otra pila. Para poder tratarla, SIGSEGV se atiende en una pila
+//alternativa
+
+//////// FUNCIONES AUXILIARES //////////
+
+static void *pilas_libres[MAX_PILAS_RESERVA];
+static int num_pilas_libres;
+static int ticks_sin_pilas;
+static void *pila_pendiente;	/* pila sobre la que termino un proceso */
+static int tam_pendiente;
+static long fallos_pagina_inicio;
+
+static long fallos_pagina() {
+
+	struct rusage uso;
+
+	getrusage(RUSAGE_SELF, &uso);
+	return uso.ru_minflt + uso.ru_majflt;
+}
+
+//Memoria residente del sistema en KB
+static unsigned int memoria_residente() {
+
+	FILE *f = fopen("/proc/self/statm", "r");
+	long total, residentes = 0;
+
+	if (f == NULL)
+		return 0;
+	if (fscanf(f, "%ld %ld", &total, &residentes) != 2)
+		residentes = 0;
+	fclose(f);
+
+	return residentes * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+//Reserva las direcciones de una pila de tam bytes y su pagina de guarda
+static void *reservar_pila(int tam) {
+
+	long pagina = sysconf(_SC_PAGESIZE);
+	char *zona = mmap(NULL, tam + pagina, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (zona == MAP_FAILED)
+		return NULL;
+
+	mprotect(zona, pagina, PROT_NONE);
+	estadisticas_pilas.creadas++;
+	return zona + pagina;
+}
+
+static void liberar_pila_reservada(void *pila, int tam) {
+
+	long pagina = sysconf(_SC_PAGESIZE);
+
+	munmap((char *)pila - pagina, tam + pagina);
+	estadisticas_pilas.liberadas++;
+}
+
+//liberar_proceso devuelve la pila cuando todavia se ejecuta sobre ella,
+//asi que no se libera hasta la siguiente operacion con pilas, que ya se
+//hace sobre la de otro proceso
+static void liberar_pila_pendiente() {
+
+	if (pila_pendiente != NULL)
+		liberar_pila_reservada(pila_pendiente, tam_pendiente);
+	pila_pendiente = NULL;
+}
+
+//Pila de tam bytes para un proceso nuevo: de la reserva si hay alguna
+void *obtener_pila(int tam) {
+
+	ticks_sin_pilas = 0;
+	liberar_pila_pendiente();
+
+	if ((tam != TAM_PILA) || (num_pilas_libres == 0))
+		return reservar_pila(tam);
+
+	estadisticas_pilas.reutilizadas++;
+	rellenar_pila(pilas_libres[num_pilas_libres - 1], TAM_PILA);
+	return pilas_libres[--num_pilas_libres];
+}
+
+//Guarda la pila de un proceso que termina. Con la reserva desactivada o
+//llena, o si no es del tamano por defecto, se libera
+void devolver_pila(void *pila, int tam) {
+
+	ticks_sin_pilas = 0;
+	liberar_pila_pendiente();
+
+	if ((tam != TAM_PILA) || (max_pilas_libres == 0) ||
+		(num_pilas_libres == MAX_PILAS_RESERVA)) {
+
+		pila_pendiente = pila;
+		tam_pendiente = tam;
+		return;
+	}
+
+	pilas_libres[num_pilas_libres++] = pila;
+}
+
+static void recortar_pilas(int max) {
+
+	while (num_pilas_libres > max)
+		liberar_pila_reservada(pilas_libres[--num_pilas_libres], TAM_PILA);
+}
+
+//SIGSEGV, instalada por el HAL, pasa a tratarse en una pila propia: la
+//del proceso puede estar agotada
+void iniciar_pilas() {
+
+	struct sigaction act;
+	stack_t alternativa;
+
+	alternativa.ss_sp = malloc(TAM_PILA_EXCEPCIONES);
+	alternativa.ss_size = TAM_PILA_EXCEPCIONES;
+	alternativa.ss_flags = 0;
+	if ((alternativa.ss_sp == NULL) || (sigaltstack(&alternativa, NULL) < 0))
+		panico("no se pudo crear la pila de excepciones");
+
+	sigaction(SIGSEGV, NULL, &act);
+	act.sa_flags |= SA_ONSTACK;
+	sigaction(SIGSEGV, &act, NULL);
+}
+
+//Recorte de la reserva cuando no se usa. Se invoca desde int_reloj
+void cuentaAtrasPilas() {
+
+	if (++ticks_sin_pilas >= TICKS_RECORTE_PILAS)
+		recortar_pilas(max_pilas_libres);
+}
+
+////////// LLAMADAS ////////////
+
+//Fija las pilas que se conservan sin usar (0 desactiva la reserva) y
+//deja ya reservadas esas pilas. Falla si no se pueden reservar todas,
+//aunque se quedan las que se hayan podido
+int sis_ajustar_pilas() {
+
+	int n = (int)leer_registro(1);
+
+	if ((n < 0) || (n > MAX_PILAS_RESERVA)) {
+
+		printk("Tamano de la reserva de pilas no valido (0-%d). ERROR\n", MAX_PILAS_RESERVA);
+		return -1;
+	}
+
+	max_pilas_libres = n;
+	recortar_pilas(n);
+	while (num_pilas_libres < n) {
+
+		void *pila = reservar_pila(TAM_PILA);
+
+		if (pila == NULL) {
+
+			printk("Solo se han podido reservar %d pilas. ERROR\n", num_pilas_libres);
+			return -1;
+		}
+		pilas_libres[num_pilas_libres++] = pila;
+	}
+
+	return 0;
+}
+
+//Copia las estadisticas de la reserva, con los fallos de pagina del
+//sistema desde la ultima llamada y la memoria residente, y las pone a cero
+int sis_estadisticas_pilas() {
+
+	struct estad_pilas *estad = (struct estad_pilas *)leer_registro(1);
+	long fallos = fallos_pagina();
+
+	estadisticas_pilas.libres = num_pilas_libres;
+	estadisticas_pilas.fallos_pagina = fallos - fallos_pagina_inicio;
+	estadisticas_pilas.residente_kb = memoria_residente();
+	if (estad != NULL)
+		copiar_parametro(estad, &estadisticas_pilas, sizeof(struct estad_pilas));
+
+	memset(&estadisticas_pilas, 0, sizeof(struct estad_pilas));
+	fallos_pagina_inicio = fallos;
+	return 0;
+}
+
+//////////////////////
+// RECLAMO DE PILAS //
+//////////////////////
+
+//La parte de la pila que queda por debajo del puntero de pila guardado de
+//un proceso bloqueado no contiene nada vivo. Si lleva bloqueado mas de
+//ticks_reclamo, esas paginas se devuelven al sistema con MADV_DONTNEED.
+//Antes de que vuelva a ejecutar se tocan de nuevo para que el proceso no
+//pague los fallos de pagina, y se mide lo que cuesta
+
+//////// FUNCIONES AUXILIARES //////////
+
+static int ticks_revision_reclamo;
+
+//Saca al proceso de la cola de bloqueados pendientes de reclamo
+static void quitar_reclamo(BCP *proc) {
+
+	if (!proc->en_cola_reclamo)
+		return;
+
+	if (proc->anterior_reclamo != NULL)
+		proc->anterior_reclamo->siguiente_reclamo = proc->siguiente_reclamo;
+	else
+		primero_reclamo = proc->siguiente_reclamo;
+
+	if (proc->siguiente_reclamo != NULL)
+		proc->siguiente_reclamo->anterior_reclamo = proc->anterior_reclamo;
+	else
+		ultimo_reclamo = proc->anterior_reclamo;
+
+	proc->en_cola_reclamo = 0;
+}
+
+//Puntero de pila guardado en el contexto del proceso
+static char *puntero_pila(BCP *proc) {
+
+#if defined(REG_RSP)
+	return (char *)proc->contexto_regs.ctxt.uc_mcontext.gregs[REG_RSP];
+#else
+	return (char *)proc->contexto_regs.ctxt.uc_mcontext.gregs[REG_ESP];
+#endif
+}
+
+static void reclamar_pila(BCP *proc) {
+
+	long pagina = sysconf(_SC_PAGESIZE);
+	char *pila = proc->pila;
+	char *sp = puntero_pila(proc);
+	unsigned char residentes[TAM_PILA_MAX / 4096];
+	char *limite, *desde;
+	int n, i, primera = -1, cuenta = 0;
+
+	char marca;
+
+	//Si esta en el manejador de avisos su pila es otra
+	if ((sp <= pila) || (sp > pila + proc->tam_pila))
+		return;
+
+	//Cuando no hay procesos listos el kernel espera sobre la pila del
+	//ultimo que se bloqueo: su contexto guardado no es el actual
+	if ((&marca >= pila) && (&marca < pila + proc->tam_pila))
+		return;
+
+	//Respeta los 128 bytes bajo el puntero de pila que puede usar el codigo
+	limite = pila + ((sp - 128 - pila) / pagina) * pagina;
+	n = (limite - pila) / pagina;
+	if ((n <= 0) || (n > sizeof(residentes)) || (mincore(pila, limite - pila, residentes) < 0))
+		return;
+
+	for (i = 0; i < n; i++)
+		if (residentes[i] & 1) {
+
+			if (primera < 0)
+				primera = i;
+			cuenta++;
+		}
+	if (cuenta == 0)
+		return;
+
+	desde = pila + primera * pagina;
+	medir_pila(proc); /* lo reclamado tambien se habia usado */
+	madvise(desde, limite - desde, MADV_DONTNEED);
+	proc->reclamada_desde = desde;
+	proc->reclamada_hasta = limite;
+
+	estadisticas_reclamo.procesos++;
+	estadisticas_reclamo.bytes_reclamados += cuenta * pagina;
+}
+
+//Anota al final de la cola de reclamo al proceso que se acaba de
+//bloquear. Se invoca con las interrupciones inhibidas
+void encolar_reclamo(BCP *proc) {
+
+	quitar_reclamo(proc);
+
+	proc->siguiente_reclamo = NULL;
+	proc->anterior_reclamo = ultimo_reclamo;
+	if (ultimo_reclamo != NULL)
+		ultimo_reclamo->siguiente_reclamo = proc;
+	else
+		primero_reclamo = proc;
+	ultimo_reclamo = proc;
+	proc->en_cola_reclamo = 1;
+}
+
+//Devuelve las paginas reclamadas antes de que el proceso ejecute. Se
+//invoca al elegirlo para ejecutar
+void restaurar_pila(BCP *proc) {
+
+	long pagina = sysconf(_SC_PAGESIZE);
+	struct timeval t0, t1;
+	volatile char *p;
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+	quitar_reclamo(proc);
+	fijar_nivel_int(nivel);
+
+	if (proc->reclamada_desde == NULL)
+		return;
+
+	gettimeofday(&t0, NULL);
+	for (p = proc->reclamada_desde; p < (char *)proc->reclamada_hasta; p += pagina)
+		*p = 0;
+	gettimeofday(&t1, NULL);
+
+	proc->reclamada_desde = proc->reclamada_hasta = NULL;
+	estadisticas_reclamo.restauraciones++;
+	estadisticas_reclamo.us_restauracion += (t1.tv_sec - t0.tv_sec) * 1000000 +
+		(t1.tv_usec - t0.tv_usec);
+}
+
+//Revisa cada TICKS_REVISION_RECLAMO los procesos bloqueados. Se invoca
+//desde int_reloj
+void cuentaAtrasReclamo() {
+
+	if ((ticks_reclamo == 0) || (++ticks_revision_reclamo < TICKS_REVISION_RECLAMO))
+		return;
+	ticks_revision_reclamo = 0;
+
+	//La cola esta ordenada por tick_bloqueo: basta con mirar su principio
+	while ((primero_reclamo != NULL) &&
+		(num_ticks - primero_reclamo->tick_bloqueo >= ticks_reclamo)) {
+
+		BCP *proc = primero_reclamo;
+
+		quitar_reclamo(proc);
+		if (proc->estado == BLOQUEADO)
+			reclamar_pila(proc);
+	}
+}
+
+////////// LLAMADAS ////////////
+
+//Fija los ticks que tiene que llevar bloqueado un proceso para reclamar
+//su pila (0 desactiva el reclamo)
+int sis_ajustar_reclamo() {
+
+	int ticks = (int)leer_registro(1);
+
+	if (ticks < 0) {
+
+		printk("Umbral de reclamo de pilas no valido. ERROR\n");
+		return -1;
+	}
+
+	ticks_reclamo = ticks;
+	return 0;
+}
+
+int sis_estadisticas_reclamo() {
+
+	struct estad_reclamo *estad = (struct estad_reclamo *)leer_registro(1);
+
+	if (estad != NULL)
+		copiar_parametro(estad, &estadisticas_reclamo, sizeof(struct estad_reclamo));
+
+	memset(&estadisticas_reclamo, 0, sizeof(struct estad_reclamo));
+	return 0;
+}
+
+/////////////////
+// USO DE PILA //
+/////////////////
+
+//Las pilas empiezan a cero, que hace de patron de relleno: las nuevas ya
+//vienen asi del sistema sin ocupar memoria y las de la reserva se vuelven
+//a poner a cero al reutilizarlas. La parte usada es la que hay desde el
+//primer byte distinto de cero hasta el final. Las paginas no residentes
+//no se han tocado, por lo que ni se recorren. Se mide al terminar el
+//proceso, antes de reclamar su pila y al pedirlo con uso_pila
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Primera pagina residente de la pila, o su final si no hay ninguna
+static char *primera_residente(char *pila, int tam) {
+
+	long pagina = sysconf(_SC_PAGESIZE);
+	unsigned char residentes[TAM_PILA_MAX / 4096];
+	int n = tam / pagina;
+
+	if ((n > sizeof(residentes)) || (mincore(pila, tam, residentes) < 0))
+		return pila;
+
+	for (int i = 0; i < n; i++)
+		if (residentes[i] & 1)
+			return pila + i * pagina;
+
+	return pila + tam;
+}
+
+//Pone a cero la parte usada de una pila de la reserva
+void rellenar_pila(void *pila, int tam) {
+
+	char *desde = primera_residente(pila, tam);
+
+	memset(desde, 0, (char *)pila + tam - desde);
+}
+
+//Bytes usados de la pila del proceso como maximo hasta ahora
+unsigned int medir_pila(BCP *proc) {
+
+	char *fin = (char *)proc->pila + proc->tam_pila;
+	long *p = (long *)primera_residente(proc->pila, proc->tam_pila);
+
+	while (((char *)p < fin) && (*p == 0))
+		p++;
+
+	if (fin - (char *)p > proc->max_pila)
+		proc->max_pila = fin - (char *)p;
+	return proc->max_pila;
+}
+
+static uso_pila_prog *buscar_uso_pila(char *prog) {
+
+	for (int i = 0; i < NUM_USOS_PILA; i++)
+		if ((array_usos_pila[i].nombre[0] != '\0') &&
+			(strcmp(array_usos_pila[i].nombre, prog) == 0))
+			return &array_usos_pila[i];
+
+	return NULL;
+}
+
+//Asocia el proceso a una entrada (NULL si no se mide) y lo anota entre
+//los vivos de esta
+void unir_uso_pila(BCP *proc, uso_pila_prog *uso) {
+
+	proc->max_pila = 0;
+	proc->uso_pila = uso;
+	if (uso == NULL)
+		return;
+
+	proc->siguiente_uso_pila = uso->vivos;
+	uso->vivos = proc;
+}
+
+//Asocia el proceso a la entrada de su programa, creandola si no existe.
+//Sin entradas libres el proceso no se mide
+void asignar_uso_pila(BCP *proc, char *prog) {
+
+	uso_pila_prog *uso = buscar_uso_pila(prog);
+
+	if ((uso == NULL) && (strlen(prog) <= MAX_NOM_PROG))
+		for (int i = 0; i < NUM_USOS_PILA; i++)
+			if (array_usos_pila[i].nombre[0] == '\0') {
+
+				uso = &array_usos_pila[i];
+				strcpy(uso->nombre, prog);
+				uso->procesos = uso->maximo = 0;
+				uso->total = 0;
+				uso->vivos = NULL;
+				break;
+			}
+
+	unir_uso_pila(proc, uso);
+}
+
+//Anota el uso de pila del proceso que termina en su programa y lo quita
+//de sus vivos
+void anotar_uso_pila(BCP *proc) {
+
+	unsigned int usado = medir_pila(proc);
+	uso_pila_prog *uso = proc->uso_pila;
+
+	if (uso == NULL)
+		return;
+
+	BCP **pp = &uso->vivos;
+	while (*pp != proc)
+		pp = &(*pp)->siguiente_uso_pila;
+	*pp = proc->siguiente_uso_pila;
+
+	uso->procesos++;
+	uso->total += usado;
+	if (usado > uso->maximo)
+		uso->maximo = usado;
+}
+
+//Se invoca en volcar_estadisticas
+void volcar_uso_pilas() {
+
+	printk("-> USO DE PILA (bytes)\n");
+	printk("%-16s %8s %8s %8s\n", "programa", "procesos", "maximo", "medio");
+
+	for (int i = 0; i < NUM_USOS_PILA; i++) {
+
+		uso_pila_prog *uso = &array_usos_pila[i];
+
+		if (uso->procesos == 0)
+			continue;
+
+		printk("%-16s %8u %8u %8u\n", uso->nombre, uso->procesos, uso->maximo,
+			(unsigned int)(uso->total / uso->procesos));
+	}
+}
+
+////////// LLAMADAS ////////////
+
+//Uso de pila de un programa: el de sus procesos terminados y, en el
+//maximo, tambien el de los vivos, que se miden ahora
+int sis_uso_pila() {
+
+	char *prog = (char *)leer_registro(1);
+	struct uso_pila *uso_usuario = (struct uso_pila *)leer_registro(2);
+	uso_pila_prog *uso;
+	struct uso_pila res;
+
+	if ((strlen(prog) > MAX_NOM_PROG) || ((uso = buscar_uso_pila(prog)) == NULL)) {
+
+		printk("No se ha ejecutado ningun programa %s. ERROR\n", prog);
+		return -1;
+	}
+
+	res.procesos = uso->procesos;
+	res.maximo = uso->maximo;
+	res.medio = (uso->procesos > 0) ? uso->total / uso->procesos : 0;
+	res.vivos = 0;
+
+	for (BCP *proc = uso->vivos; proc != NULL; proc = proc->siguiente_uso_pila) {
+
+		res.vivos++;
+		if (medir_pila(proc) > res.maximo)
+			res.maximo = proc->max_pila;
+	}
+
+	copiar_parametro(uso_usuario, &res, sizeof(struct uso_pila));
+	return 0;
+}
+
+///////////
+// HILOS //
+///////////
+
+//Un hilo es un BCP mas, con su pid, su pila y su contexto, que ejecuta
+//una funcion del programa del proceso que lo crea y comparte con el la
+//imagen y los descriptores. Lo comun esta en un grupo_hilos, que se crea
+//con el primer hilo. Los descriptores se cierran y la imagen se suelta
+//solo al terminar el ultimo hilo; los demas dejan el valor con que
+//terminan para esperar_hilo. Los hilos no tienen padre: su estado no lo
+//recoge esperar_proceso. El proceso termina, con el estado de su hilo
+//inicial, cuando lo hace el ultimo
+
+//////// FUNCIONES AUXILIARES //////////
+
+//Grupo del proceso actual. Si no tiene, lo crea con sus descriptores
+static grupo_hilos *grupo_actual() {
+
+	BCP *p = p_proc_actual;
+	grupo_hilos *g = p->grupo;
+
+	if (g != NULL)
+		return g;
+
+	g = malloc(sizeof(grupo_hilos));
+	if (g == NULL)
+		return NULL;
+
+	memcpy(g->descriptores, p->descriptores, sizeof(g->descriptores));
+	g->n_descriptores = *p->n_descriptores;
+	g->hilos = 1;
+	g->terminados = NULL;
+	g->esperando.primero = g->esperando.ultimo = NULL;
+	g->registro = NULL;
+
+	p->grupo = g;
+	p->descriptores = g->descriptores;
+	p->n_descriptores = &g->n_descriptores;
+	return g;
+}
+
+//Saca del grupo al hilo actual, que termina. Devuelve 1 si es el ultimo,
+//o no tenia grupo, y hay que liberar lo compartido. Si no, suelta los
+//mutex y cerrojos que tuviera, libera las regiones de las que es
+//propietario (ningun otro hilo puede acceder a ellas) y deja su valor a
+//quien lo espere
+int salir_del_grupo(int valor) {
+
+	grupo_hilos *g = p_proc_actual->grupo;
+
+	if (g == NULL)
+		return 1;
+	if (--g->hilos == 0)
+		return 1;
+
+	for (int i = 0; i < NUM_DESC_PROC; i++) {
+
+		descriptor *d = &g->descriptores[i];
+
+		if (d->tipo == DESC_MUTEX) {
+
+			mutex *m = &array_mutex[d->id];
+
+			if ((m->locked != 0) && (m->propietario == p_proc_actual->id))
+				liberar_mutex(m);
+		}
+		else if ((d->tipo == DESC_CERROJO) && (p_proc_actual->modo_cerrojos[i] != 0))
+			soltar_cerrojo(p_proc_actual, i);
+		else if ((d->tipo == DESC_REGION) && (array_regiones[d->id].propietario == p_proc_actual->id))
+			cerrar_descriptor_region(i);
+	}
+
+	//Sin memoria el valor se pierde: esperar_hilo fallara con ese pid
+	zombi *z = malloc(sizeof(zombi));
+
+	if (z == NULL)
+		printk("No hay memoria para guardar el valor del hilo %d. ERROR\n", p_proc_actual->id);
+	else {
+
+		z->pid = p_proc_actual->id;
+		z->estado = valor;
+		z->grupo = NULL;
+		z->siguiente = g->terminados;
+		g->terminados = z;
+	}
+
+	while (desbloquear_primero(&g->esperando) != NULL);
+	return 0;
+}
+
+//Libera el grupo del ultimo hilo, ya con los descriptores cerrados
+void liberar_grupo() {
+
+	grupo_hilos *g = p_proc_actual->grupo;
+
+	if (g == NULL)
+		return;
+
+	while (g->terminados != NULL) {
+
+		zombi *z = g->terminados;
+		g->terminados = z->siguiente;
+		free(z);
+	}
+
+	p_proc_actual->grupo = NULL;
+	p_proc_actual->descriptores = p_proc_actual->descriptores_propios;
+	p_proc_actual->n_descriptores = &p_proc_actual->n_descriptores_propio;
+	free(g);
+}
+
+////////// LLAMADAS ////////////
+
+//Crea un hilo que empieza en entrada, una funcion de la biblioteca que
+//recoge con tomar_hilo la funcion y el argumento. Devuelve su pid
+int sis_crear_hilo() {
+
+	void *entrada = (void *)leer_registro(1);
+	BCP *p_hilo;
+
+	printk("-> PROC %d: CREAR HILO\n", p_proc_actual->id);
+
+	if ((p_hilo = buscar_BCP_libre()) == NULL) {
+
+		printk("No hay entradas libres en la tabla de procesos. ERROR\n");
+		return -1;
+	}
+
+	if (grupo_actual() == NULL) {
+
+		devolver_BCP(p_hilo);
+		printk("No hay memoria para el grupo de hilos. ERROR\n");
+		return -1;
+	}
+
+	//La imagen es la del proceso: la referencia a la cache es del grupo
+	p_hilo->imagen = p_proc_actual->imagen;
+	iniciar_tarea(p_hilo, NULL, p_proc_actual->info_mem, entrada, TAM_PILA, p_proc_actual);
+	p_hilo->funcion_hilo = (void *)leer_registro(2);
+	p_hilo->argumento_hilo = (void *)leer_registro(3);
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+	insertar_ultimo(&lista_listos, p_hilo);
+	fijar_nivel_int(nivel);
+
+	return p_hilo->id;
+}
+
+//Copia la funcion y el argumento del hilo actual
+int sis_tomar_hilo() {
+
+	void **funcion = (void **)leer_registro(1);
+	void **argumento = (void **)leer_registro(2);
+
+	if (p_proc_actual->grupo == NULL) {
+
+		printk("El proceso no es un hilo. ERROR\n");
+		return -1;
+	}
+
+	copiar_parametro(funcion, &p_proc_actual->funcion_hilo, sizeof(void *));
+	copiar_parametro(argumento, &p_proc_actual->argumento_hilo, sizeof(void *));
+	return 0;
+}
+
+//Espera a que termine otro hilo del mismo proceso y recoge su valor
+int sis_esperar_hilo() {
+
+	int pid = (int)leer_registro(1);
+	int *valor = (int *)leer_registro(2);
+	grupo_hilos *g = p_proc_actual->grupo;
+
+	if ((g == NULL) || (pid == p_proc_actual->id)) {
+
+		printk("El proceso %d no es otro hilo de este proceso. ERROR\n", pid);
+		return -1;
+	}
+
+	int nivel = fijar_nivel_int(NIVEL_3);
+
+	while (1) {
+
+		for (zombi **pz = &g->terminados; *pz != NULL; pz = &(*pz)->siguiente)
+			if ((*pz)->pid == pid) {
+
+				zombi *z = *pz;
+				*pz = z->siguiente;
+				fijar_nivel_int(nivel);
+
+				if (valor != NULL)
+					copiar_parametro(valor, &z->estado, sizeof(int));
+				free(z);
+				return 0;
+			}
+
+		BCP *p = buscar_proceso(pid);
+		if ((p == NULL) || (p->grupo != g)) {
+
+			fijar_nivel_int(nivel);
+			printk("El proceso %d no es otro hilo de este proceso. ERROR\n", pid);
+			return -1;
+		}
+
+		bloquear_proceso(&g->esperando);
+	}
+}
+
+///////////////////////////
+// CESION DEL PROCESADOR //
+///////////////////////////
+
+/*
+ * Cede voluntariamente la UCP: expulsa al proceso actual por el mismo
+ * camino que el fin de rodaja (int_sw), asi que pasa al final de la lista
+ * de listos. Si no hay otro listo sigue ejecutando
+ */
+int sis_ceder_procesador() {
+
+	Proceso_Expulsar = p_proc_actual;
+	activar_int_SW();
+	return 0;
+}
+
 int liberarTodosLosProcesosBloqueadosMutex(mutex* m){
 
 	printk("Liberando procesos bloqueados en el mutex %s.\n", m->nombre);
@@ -1021,9 +5536,12 @@ int main(){
 	iniciar_cont_teclado();		/* inici cont. teclado */
 
 	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	iniciar_ficheros();		/* sistema de ficheros con solo la raiz */
+	iniciar_disco();		/* cache del disco y su hilo */
+	iniciar_pilas();		/* pila para desbordamientos */
 
 	/* crea proceso inicial */
-	if (crear_tarea((void *)"init")<0)
+	if (crear_tarea((void *)"init", TAM_PILA)<0)
 		panico("no encontrado el proceso inicial");
 	
 	/* activa proceso inicial */
@@ -0,0 +1,38 @@
+/*
+ * usuario/avisador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de esperar_multiple:
+ * toma el mutex "mm", senala el semaforo "sm" y suelta el mutex un
+ * segundo despues
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mm, sm, id;
+
+	id=obtener_id_pr();
+
+	if ((mm=abrir_mutex("mm"))<0)
+		printf("error abriendo mm. NO DEBE APARECER\n");
+	if ((sm=abrir_sem("sm"))<0)
+		printf("error abriendo sm. NO DEBE APARECER\n");
+
+	lock(mm);
+	printf("avisador (%d) senala sm en tick %d\n", id, tiempos_proceso(0));
+	senalar_sem(sm);
+
+	dormir(1);
+	printf("avisador (%d) suelta mm en tick %d\n", id, tiempos_proceso(0));
+	unlock(mm);
+
+	printf("avisador (%d) termina\n", id);
+	return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * usuario/consumidor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de los semaforos
+ */
+
+#include "servicios.h"
+
+#define TOT_ELEM 5
+
+int main(){
+	int huecos, elems, i;
+
+	printf("consumidor comienza\n");
+
+	if ((huecos=abrir_sem("huecos"))<0)
+		printf("error abriendo huecos. NO DEBE APARECER\n");
+
+	if ((elems=abrir_sem("elems"))<0)
+		printf("error abriendo elems. NO DEBE APARECER\n");
+
+	for (i=1; i<=TOT_ELEM; i++) {
+		esperar_sem(elems);
+		printf("consumidor consume %d\n", i);
+		senalar_sem(huecos);
+	}
+
+	if (cerrar_sem(elems)<0)
+		printf("error cerrando elems. NO DEBE APARECER\n");
+
+	if (esperar_sem(elems)<0)
+		printf("error esperando en semaforo cerrado. DEBE APARECER\n");
+
+	printf("consumidor termina\n");
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * usuario/contendiente.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_traspaso: bloquea y
+ * desbloquea repetidamente el mutex "banco".
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 200	/* ponga las que considere oportuno */
+
+int main(){
+	int i, id, desc, t0=0, t1;
+
+	id=obtener_id_pr();
+
+	if ((desc=abrir_mutex("banco"))<0) {
+		printf("contendiente (%d): error abriendo banco\n", id);
+		return 0;
+	}
+
+	for (i=0; i<TOT_ITER; i++) {
+		if (lock(desc)<0)
+			printf("error en lock de mutex. NO DEBE APARECER\n");
+		if (i==0)
+			t0=tiempos_proceso(0);
+		if (unlock(desc)<0)
+			printf("error en unlock de mutex. NO DEBE APARECER\n");
+	}
+	t1=tiempos_proceso(0);
+
+	printf("contendiente (%d): %d adquisiciones entre tick %d y %d\n",
+		id, TOT_ITER, t0, t1);
+	return 0;
+}
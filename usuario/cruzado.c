@@ -0,0 +1,41 @@
+/*
+ * usuario/cruzado.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de lock_varios: pide
+ * los mutex "ma" y "mb" en el orden contrario al de prueba_varios
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 100
+
+int main(){
+	unsigned int descs[2];
+	int id, i, j;
+
+	id=obtener_id_pr();
+
+	descs[1]=abrir_mutex("ma");
+	descs[0]=abrir_mutex("mb");
+
+	/* mb lo tiene prueba_varios: se espera sin retener ma */
+	lock_varios(descs, 2);
+	printf("cruzado (%d) obtiene mb y ma en tick %d\n", id, tiempos_proceso(0));
+	unlock_varios(descs, 2);
+
+	for (i=0; i<ITERACIONES; i++) {
+		lock_varios(descs, 2);
+		for (j=0; j<1000000; j++);
+		unlock_varios(descs, 2);
+	}
+
+	printf("cruzado (%d) termina\n", id);
+	return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * usuario/efimero.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de la tabla de
+ * procesos: termina nada mas empezar, cerrando de forma implicita las
+ * tuberias heredadas.
+ */
+
+#include "servicios.h"
+
+int main(){
+	/* la llamada explicita hace que se enlace la biblioteca, que es
+	   donde esta el punto de entrada del programa */
+	terminar_proceso();
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*
+ * usuario/esperador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de las variables
+ * condicion: espera en la condicion cc protegida por el mutex mc.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, id;
+
+	id=obtener_id_pr();
+
+	if ((mut=abrir_mutex("mc"))<0)
+		printf("error abriendo mc. NO DEBE APARECER\n");
+
+	if ((cond=abrir_cond("cc"))<0)
+		printf("error abriendo cc. NO DEBE APARECER\n");
+
+	lock(mut);
+	printf("esperador (%d) espera en cc\n", id);
+	if (esperar_cond(cond, mut)<0)
+		printf("error en esperar_cond. NO DEBE APARECER\n");
+	printf("esperador (%d) despierta con el mutex mc\n", id);
+	unlock(mut);
+
+	printf("esperador (%d) termina\n", id);
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * usuario/hondo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba del reclamo de pilas:
+ * ocupa unos 24 KB de pila, vuelve y duerme 3 segundos con la pila casi
+ * vacia. Al despertar vuelve a bajar y termina con estado 1 si los datos
+ * que escribe en la pila siguen bien.
+ */
+
+#include "servicios.h"
+
+#define NIVELES 24
+
+static int bajar(int nivel) {
+	volatile char marco[1024];
+	int i, bien;
+
+	for (i=0; i<sizeof(marco); i++)
+		marco[i]=nivel;
+	bien=(nivel==NIVELES) ? 1 : bajar(nivel+1);
+	for (i=0; i<sizeof(marco); i++)
+		if (marco[i]!=(char)nivel)
+			bien=0;
+	return bien;
+}
+
+int main(){
+	int bien;
+
+	bien=bajar(1);
+	dormir(3);
+	bien=bien && bajar(1);
+	terminar_con_estado(bien);
+	return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * usuario/inactivo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de la tabla de
+ * procesos: permanece bloqueado hasta que prueba_procesos cierra la
+ * tuberia heredada.
+ */
+
+#include "servicios.h"
+
+#define FONDO 0		/* tuberia heredada de prueba_procesos */
+
+int main(){
+	char c;
+
+	cerrar_tuberia(FONDO+1);
+	while (leer_tuberia(FONDO, &c, 1)>0);
+	return 0;
+}
@@ -32,6 +32,7 @@ void cuentaAtrasBloqueados();
 /////////////////////////
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
+#define TRASPASO 2 /* se suma al tipo: cesion directa y FIFO del mutex */
 
 int crear_mutex(char* nombre, int tipo);
 int abrir_mutex(char* nombre);
@@ -39,6 +40,317 @@ int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
 
+/* Estadisticas de contencion de un mutex (tiempos en ticks) */
+struct estad_mutex {
+	unsigned int adquisiciones;
+	unsigned int adquisiciones_con_espera;
+	unsigned int ticks_espera;
+	unsigned int max_ticks_espera;
+	unsigned int ticks_retencion;
+	unsigned int max_ticks_retencion;
+	unsigned int max_esperando;
+};
+
+int estadisticas_mutex(unsigned int mutexid, struct estad_mutex *est);
+
+//////////////////////////////////////////////////
+// Servicios de semaforos y variables condicion //
+//////////////////////////////////////////////////
+
+int crear_sem(char* nombre, unsigned int valor);
+int abrir_sem(char* nombre);
+int esperar_sem(unsigned int semid);
+int senalar_sem(unsigned int semid);
+int cerrar_sem(unsigned int semid);
+
+int crear_cond(char* nombre);
+int abrir_cond(char* nombre);
+int esperar_cond(unsigned int condid, unsigned int mutexid);
+int senalar_cond(unsigned int condid);
+int difundir_cond(unsigned int condid);
+int cerrar_cond(unsigned int condid);
+
+///////////////////////////////////////////////
+// Servicios de cerrojos lectores/escritores //
+///////////////////////////////////////////////
+#define PREF_LECTORES 0
+#define PREF_ESCRITORES 1
+
+int crear_cerrojo(char* nombre, int preferencia);
+int abrir_cerrojo(char* nombre);
+int lock_lectura(unsigned int cerrojoid);
+int lock_escritura(unsigned int cerrojoid);
+int unlock_cerrojo(unsigned int cerrojoid);
+int cerrar_cerrojo(unsigned int cerrojoid);
+
+///////////////////////////
+// Servicios de barreras //
+///////////////////////////
+
+int crear_barrera(char* nombre, unsigned int participantes);
+int abrir_barrera(char* nombre);
+int esperar_barrera(unsigned int barreraid);
+int cerrar_barrera(unsigned int barreraid);
+
+///////////////////////
+// Servicio terminal //
+///////////////////////
+
+int leer_caracter();
+
+//////////////////////////////
+// Servicio espera multiple //
+//////////////////////////////
+
+#define EVENTO_MUTEX 0		/* el mutex esta libre */
+#define EVENTO_SEM 1		/* el semaforo tiene valor positivo */
+#define EVENTO_TERMINAL 2	/* hay caracteres del terminal sin leer */
+
+#define MAX_EVENTOS 8		/* maximo de eventos por llamada */
+#define ESPERA_TIMEOUT -2	/* devuelto si vence el plazo */
+
+struct evento {
+	int tipo;
+	unsigned int desc;	/* no se usa con EVENTO_TERMINAL */
+};
+
+/* timeout en ms: negativo sin limite, 0 solo consulta */
+int esperar_multiple(struct evento *eventos, int n, int timeout);
+
+////////////////////////////
+// Servicios varios mutex //
+////////////////////////////
+
+/* todos o ninguno: se espera sin retener ninguno de los mutex */
+int lock_varios(unsigned int *descs, int n);
+int unlock_varios(unsigned int *descs, int n);
+
+///////////////////////////
+// Servicios de tuberias //
+///////////////////////////
+
+/* descs[0] lectura, descs[1] escritura; crear_proceso los hereda */
+int crear_tuberia(int descs[2]);
+int leer_tuberia(unsigned int desc, void *buf, int tam);
+int escribir_tuberia(unsigned int desc, void *buf, int tam);
+int cerrar_tuberia(unsigned int desc);
+
+/////////////////////////////////////
+// Servicios de memoria compartida //
+/////////////////////////////////////
+
+/* devuelven un descriptor y la direccion del segmento en *dir */
+int crear_segmento(char *nombre, int tam, void **dir);
+int asociar_segmento(char *nombre, void **dir, int *tam);
+int desasociar_segmento(unsigned int segid);
+
+///////////////////////////////////
+// Servicios de paso de mensajes //
+///////////////////////////////////
+
+#define TAM_MENSAJE 64	/* tamano maximo de un mensaje */
+
+/* recibir: *pid es el origen (-1 cualquiera) y a la vuelta el emisor */
+int enviar(int pid, void *msg, int tam);
+int recibir(int *pid, void *msg, int tam);
+/* la respuesta se deja en msg, que debe tener TAM_MENSAJE bytes */
+int llamar(int pid, void *msg, int tam);
+int responder(int pid, void *msg, int tam);
+int responder_y_recibir(int *pid, void *msg, int tam);
+
+/////////////////////////
+// Servicios de avisos //
+/////////////////////////
+
+#define AVISO_ALARMA 0x40000000	/* lo genera el kernel; el resto son libres */
+
+/* el manejador recibe de una vez todos los avisos pendientes. Se ejecuta
+   al volver de una llamada o de una expulsion, nunca anidado */
+int registrar_avisos(void (*manejador)(int avisos));
+int notificar(int pid, int avisos);
+int esperar_avisos();
+int alarma_aviso(int ms);	/* 0 cancela la alarma */
+
+///////////////////////////
+// Servicios de ficheros //
+///////////////////////////
+
+/* modos de apertura */
+#define F_LECTURA 1
+#define F_ESCRITURA 2
+#define F_CREAR 4
+#define F_TRUNCAR 8
+
+/* origen de posicionar */
+#define DESDE_INICIO 0
+#define DESDE_ACTUAL 1
+#define DESDE_FINAL 2
+
+/* las rutas son absolutas, con componentes de hasta 16 caracteres */
+int abrir(char *ruta, int modo);
+int leer_fichero(unsigned int fd, void *buf, int tam);
+int escribir_fichero(unsigned int fd, void *buf, int tam);
+int posicionar(unsigned int fd, int desp, int origen);
+int cerrar_fichero(unsigned int fd);
+int crear_directorio(char *ruta);
+int borrar(char *ruta);
+
+////////////////////////
+// Servicios de disco //
+////////////////////////
+
+/* estadisticas acumuladas de la cache de bloques */
+struct estad_disco {
+	unsigned int aciertos;		/* bloques servidos desde la cache */
+	unsigned int fallos;		/* bloques que hubo que esperar al disco */
+	unsigned int lecturas;		/* lecturas hechas en el disco */
+	unsigned int adelantadas;	/* de ellas, de lectura adelantada */
+	unsigned int escrituras;	/* escrituras hechas en el disco */
+	unsigned int ticks_espera;	/* ticks bloqueados esperando al disco */
+};
+
+/* bloques de 4096 bytes; las escrituras llegan al disco de forma diferida */
+int leer_bloque(int bloque, void *buf);
+int escribir_bloque(int bloque, void *buf);
+int sincronizar();
+int ajustar_cache(int buffers);	/* vacia la cache y fija su tamano */
+int estadisticas_disco(struct estad_disco *estad); /* y las pone a cero */
+
+/////////////////////////////////////////
+// Servicios de regiones transferibles //
+/////////////////////////////////////////
+
+/* solo el proceso propietario puede acceder a la region; al transferirla
+   el descriptor se cierra y los datos pasan al destino sin copiarse */
+int crear_region(int tam, void **dir);	/* tam se redondea a paginas */
+int transferir_region(unsigned int des, int pid);
+int recibir_region(void **dir, int *tam, int *pid); /* bloqueante */
+int liberar_region(unsigned int des);
+
+///////////////////////////////////////////
+// Servicios de espera de procesos hijos //
+///////////////////////////////////////////
+
+/* devuelven el pid del hijo y en *estado (si no es NULL) el que paso a
+   terminar_con_estado, 0 si termino de otro modo o -1 si lo aborto una
+   excepcion; el valor que devuelve main no se recoge */
+int esperar_proceso(int pid, int *estado);
+int esperar_hijo(int *estado);	/* cualquier hijo */
+int terminar_con_estado(int estado);
+
+///////////////////////////////////////
+// Servicios de la cache de imagenes //
+///////////////////////////////////////
+
+/* estadisticas de la cache de programas cargados */
+struct estad_imagenes {
+	unsigned int aciertos;		/* procesos creados con la imagen en cache */
+	unsigned int fallos;		/* procesos que tuvieron que cargarla */
+};
+
+/* imagenes sin procesos que se conservan (0 desactiva la cache) */
+int ajustar_cache_imagenes(int n);
+int estadisticas_imagenes(struct estad_imagenes *estad); /* y las pone a cero */
+
+//////////////////////////////////////
+// Servicios de la reserva de pilas //
+//////////////////////////////////////
+
+/* estadisticas de la reserva de pilas de procesos */
+struct estad_pilas {
+	unsigned int reutilizadas;	/* pilas sacadas de la reserva */
+	unsigned int creadas;		/* pilas nuevas */
+	unsigned int liberadas;		/* pilas devueltas al HAL */
+	unsigned int libres;		/* pilas en la reserva */
+	unsigned int fallos_pagina;	/* de todo el sistema */
+	unsigned int residente_kb;	/* memoria residente del sistema */
+};
+
+/* pilas sin usar que se conservan tras un rato sin crear procesos (0
+   desactiva la reserva); las deja ya creadas (-1 si no puede con todas) */
+int ajustar_pilas(int n);
+int estadisticas_pilas(struct estad_pilas *estad); /* y las pone a cero */
+
+////////////////////////////////////
+// Servicios del reclamo de pilas //
+////////////////////////////////////
+
+/* estadisticas del reclamo de las pilas de procesos bloqueados */
+struct estad_reclamo {
+	unsigned int procesos;		/* pilas reclamadas */
+	unsigned int bytes_reclamados;
+	unsigned int restauraciones;
+	unsigned int us_restauracion;	/* total de todas ellas */
+};
+
+/* ticks que debe llevar bloqueado un proceso para devolver al sistema la
+   parte de su pila que no usa (0 desactiva el reclamo) */
+int ajustar_reclamo(int ticks);
+int estadisticas_reclamo(struct estad_reclamo *estad); /* y las pone a cero */
+
+///////////////////////////////
+// Servicios del uso de pila //
+///////////////////////////////
+
+/* maximo de pila usado por los procesos de un programa */
+struct uso_pila {
+	unsigned int procesos;		/* terminados */
+	unsigned int maximo;		/* bytes, tambien de los vivos */
+	unsigned int medio;		/* bytes, de los terminados */
+	unsigned int vivos;
+};
+
+int uso_pila(char *prog, struct uso_pila *uso);
+
+////////////////////////
+// Servicios de hilos //
+////////////////////////
+
+/* crea un hilo que ejecuta funcion(argumento) compartiendo la imagen y los
+   descriptores del proceso; lo que devuelve la funcion es su valor de
+   terminacion. Devuelve el pid del hilo */
+int crear_hilo(int (*funcion)(void *), void *argumento);
+int terminar_hilo(int valor);
+int esperar_hilo(int pid, int *valor);	/* otro hilo del mismo proceso */
+/* cede la UCP al siguiente proceso listo como si acabara su rodaja */
+int ceder_procesador();
+
+//////////////////////
+// Hilos de usuario //
+//////////////////////
+
+/* Se ejecutan sobre hilos del kernel (portadores) y cambian de contexto,
+   se sincronizan y esperan sin entrar en el kernel. Como maximo 64 hilos
+   vivos con pilas de 32 KB. hu_dormir y hu_leer_caracter solo paran al
+   hilo que las llama. No se debe terminar el proceso desde uno de ellos */
+struct hu_hilo;
+typedef struct {
+	struct hu_hilo *primero, *ultimo;
+} hu_cola;
+typedef struct {
+	struct hu_hilo *propietario;
+	hu_cola esperando;
+} hu_mutex;
+typedef struct {
+	hu_cola esperando;
+} hu_cond;
+
+int hu_crear(void (*funcion)(void *), void *argumento);	/* id o -1 */
+/* ejecuta los hilos con n_portadores hilos del kernel (hasta 8) hasta que
+   terminan todos, incluidos los que se creen mientras tanto */
+int hu_ejecutar(int n_portadores);
+void hu_ceder();
+void hu_terminar();
+void hu_dormir(int ms);
+int hu_leer_caracter();
+void hu_mutex_iniciar(hu_mutex *m);
+int hu_mutex_lock(hu_mutex *m);		/* no recursivo */
+int hu_mutex_unlock(hu_mutex *m);
+void hu_cond_iniciar(hu_cond *c);
+int hu_cond_esperar(hu_cond *c, hu_mutex *m);
+void hu_cond_senalar(hu_cond *c);
+void hu_cond_difundir(hu_cond *c);
+
 ////////////////
 // AUXILIARES //
 ////////////////
@@ -53,11 +365,28 @@ int descriptor_mutex();
 int escribirf(const char *formato, ...);
 
 /* Llamadas al sistema proporcionadas */
-int crear_proceso(char *prog);
+int crear_proceso(char *prog);	/* devuelve el pid del nuevo proceso */
+/* con una pila de tam_pila bytes (0 el tamano por defecto); la memoria se
+   asigna solo a medida que se usa */
+int crear_proceso_con_pila(char *prog, int tam_pila);
+/* si la tabla de procesos esta llena espera a que termine alguno; timeout
+   en ms: negativo sin limite, 0 no espera */
+int crear_proceso_esperando(char *prog, int timeout);
+/* crea n procesos del programa (hasta 256) en una llamada y deja sus pids
+   en pids; devuelve cuantos ha creado, menos si se llena la tabla */
+int crear_procesos(char *prog, int n, int *pids);
 int terminar_proceso();
 int escribir(char *texto, unsigned int longi);
 int obtener_id_pr();
 
+// TIEMPOS
+struct tiempos_ejec {
+	int usuario;
+	int sistema;
+};
+
+int tiempos_proceso(struct tiempos_ejec *t_ejec);
+
 
 #endif /* SERVICIOS_H */
 
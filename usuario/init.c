@@ -89,6 +89,134 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 		printf("Error creando prueba_term\n");
 */
 
+/* //PRUEBA DE RENDIMIENTO DEL TRASPASO DE MUTEX
+	if (crear_proceso("prueba_traspaso")<0)
+		printf("Error creando prueba_traspaso\n");
+*/
+
+/* //PRUEBA DE SEMAFOROS
+	if (crear_proceso("prueba_sem")<0)
+		printf("Error creando prueba_sem\n");
+*/
+
+/* //PRUEBA DE VARIABLES CONDICION
+	if (crear_proceso("prueba_cond")<0)
+		printf("Error creando prueba_cond\n");
+*/
+
+/* //PRUEBA DE RENDIMIENTO DE CERROJOS DE LECTORES/ESCRITORES
+	if (crear_proceso("prueba_lect_esc")<0)
+		printf("Error creando prueba_lect_esc\n");
+*/
+
+/* //PRUEBA DE BARRERAS
+	if (crear_proceso("prueba_barrera")<0)
+		printf("Error creando prueba_barrera\n");
+*/
+
+/* //PRUEBA DE ESPERA MULTIPLE
+	if (crear_proceso("prueba_multiple")<0)
+		printf("Error creando prueba_multiple\n");
+*/
+
+/* //PRUEBA DE LOCK DE VARIOS MUTEX
+	if (crear_proceso("prueba_varios")<0)
+		printf("Error creando prueba_varios\n");
+*/
+
+/* //PRUEBA DE RENDIMIENTO DE TUBERIAS
+	if (crear_proceso("prueba_tuberia")<0)
+		printf("Error creando prueba_tuberia\n");
+*/
+
+/* //PRUEBA DE MEMORIA COMPARTIDA
+	if (crear_proceso("prueba_segmento")<0)
+		printf("Error creando prueba_segmento\n");
+*/
+
+/* //PRUEBA DE LATENCIA DEL PASO DE MENSAJES
+	if (crear_proceso("prueba_mensajes")<0)
+		printf("Error creando prueba_mensajes\n");
+*/
+
+/* //PRUEBA DE AVISOS ASINCRONOS
+	if (crear_proceso("prueba_avisos")<0)
+		printf("Error creando prueba_avisos\n");
+*/
+
+/* //PRUEBA DEL SISTEMA DE FICHEROS
+	if (crear_proceso("prueba_ficheros")<0)
+		printf("Error creando prueba_ficheros\n");
+*/
+
+/* //PRUEBA DEL DISCO Y SU CACHE DE BLOQUES
+	if (crear_proceso("prueba_disco")<0)
+		printf("Error creando prueba_disco\n");
+*/
+
+/* //PRUEBA DE REGIONES TRANSFERIBLES
+	if (crear_proceso("prueba_regiones")<0)
+		printf("Error creando prueba_regiones\n");
+*/
+
+/* //PRUEBA DE LA TABLA DE PROCESOS
+	if (crear_proceso("prueba_procesos")<0)
+		printf("Error creando prueba_procesos\n");
+*/
+
+/* //PRUEBA DE LA ESPERA POR PROCESOS HIJOS
+	if (crear_proceso("prueba_esperar")<0)
+		printf("Error creando prueba_esperar\n");
+*/
+
+/* //PRUEBA DE LA CACHE DE IMAGENES
+	if (crear_proceso("prueba_imagenes")<0)
+		printf("Error creando prueba_imagenes\n");
+*/
+
+/* //PRUEBA DE LA RESERVA DE PILAS
+	if (crear_proceso("prueba_pilas")<0)
+		printf("Error creando prueba_pilas\n");
+*/
+
+/* //PRUEBA DEL TAMANO DE PILA POR PROCESO
+	if (crear_proceso("prueba_tam_pila")<0)
+		printf("Error creando prueba_tam_pila\n");
+*/
+
+/* //PRUEBA DEL RECLAMO DE PILAS
+	if (crear_proceso("prueba_reclamo")<0)
+		printf("Error creando prueba_reclamo\n");
+*/
+
+/* //PRUEBA DEL USO DE PILA POR PROGRAMA
+	if (crear_proceso("prueba_uso_pila")<0)
+		printf("Error creando prueba_uso_pila\n");
+*/
+
+/* //PRUEBA DE LA ESPERA CON LA TABLA DE PROCESOS LLENA
+	if (crear_proceso("prueba_tabla_llena")<0)
+		printf("Error creando prueba_tabla_llena\n");
+*/
+
+/* //PRUEBA DE LA CREACION DE VARIOS PROCESOS
+	if (crear_proceso("prueba_crear_procesos")<0)
+		printf("Error creando prueba_crear_procesos\n");
+*/
+
+/* //PRUEBA DE HILOS
+	if (crear_proceso("prueba_hilos")<0)
+		printf("Error creando prueba_hilos\n");
+*/
+
+/* //PRUEBA DE HILOS DE USUARIO
+	if (crear_proceso("prueba_hilos_usuario")<0)
+		printf("Error creando prueba_hilos_usuario\n");
+*/
+
+	/* recoge a todos los procesos que ha creado */
+	while (esperar_hijo(0)>=0);
+
 	printf("init: termina\n");
 	return 0; 
 }
@@ -0,0 +1,41 @@
+/*
+ * usuario/lector_rw.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de prueba_lect_esc. Si existe el
+ * cerrojo "rw" lo adquiere en modo lectura; si no, usa el mutex "rw".
+ */
+
+#include "servicios.h"
+
+#define TOT_LECTURAS 3
+
+int main(){
+	int i, id, desc, cerrojo=1;
+
+	id=obtener_id_pr();
+
+	if ((desc=abrir_cerrojo("rw"))<0) {
+		cerrojo=0;
+		if ((desc=abrir_mutex("rw"))<0) {
+			printf("lector_rw (%d): error abriendo rw\n", id);
+			return 0;
+		}
+	}
+
+	for (i=0; i<TOT_LECTURAS; i++) {
+		if (cerrojo) lock_lectura(desc); else lock(desc);
+		printf("lector_rw (%d): lee en tick %d\n", id, tiempos_proceso(0));
+		dormir(1);
+		if (cerrojo) unlock_cerrojo(desc); else unlock(desc);
+	}
+
+	printf("lector_rw (%d): termina en tick %d\n", id, tiempos_proceso(0));
+	return 0;
+}
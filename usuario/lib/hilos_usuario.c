@@ -0,0 +1,464 @@
+/*
+ * usuario/lib/hilos_usuario.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Hilos de usuario (M:N). Los hilos se ejecutan sobre uno o varios hilos
+ * del kernel (portadores) y cambian de contexto sin entrar en el kernel:
+ * solo se salvan los registros que debe conservar una funcion y el
+ * puntero de pila. Una cola de listos comun, protegida por un cerrojo de
+ * espera activa, reparte los hilos entre los portadores. Los mutex y las
+ * condiciones de usuario tampoco entran en el kernel.
+ *
+ * Regla del cerrojo: todo cambio de contexto se hace con el cerrojo
+ * cogido y lo suelta quien continua ejecutando tras el cambio.
+ *
+ * No se debe terminar el proceso desde un hilo de usuario: su pila esta
+ * en la imagen del programa.
+ */
+
+#include <stddef.h>
+#include "servicios.h"
+
+#define MAX_HILOS_USUARIO 64
+#define TAM_PILA_HU 32768	/* incluye el tratamiento de las llamadas */
+#define MAX_PORTADORES 8
+#define TICKS_SEG 100		/* TICK del kernel */
+#define REVISION_HU 64		/* despachos entre revisiones de esperas */
+#define ESPERA_HU_MS 10		/* espera de un portador sin hilos listos */
+
+/* Estados de un hilo de usuario */
+#define LIBRE 0
+#define LISTO 1
+#define EJECUTANDO 2
+#define BLOQUEADO 3
+#define DORMIDO 4
+#define TERMINAL 5
+#define TERMINADO 6
+
+struct portador {
+	void *sp;		/* contexto del bucle del portador */
+};
+
+struct hu_hilo {
+	void *sp;		/* puntero de pila guardado */
+	int estado;
+	void (*funcion)(void *);
+	void *argumento;
+	struct portador *portador;
+	int despertar;		/* tick en que acaba de dormir */
+	struct hu_hilo *siguiente;
+};
+
+static struct hu_hilo hilos[MAX_HILOS_USUARIO];
+static char pilas[MAX_HILOS_USUARIO][TAM_PILA_HU] __attribute__((aligned(16)));
+static struct portador portadores[MAX_PORTADORES];
+
+static hu_cola listos, dormidos, terminal;
+static int vivos;
+static volatile int cerrojo;
+
+/*
+ * Cambio de contexto: guarda el puntero de pila en *guardar tras apilar
+ * los registros que debe conservar la funcion, y continua en el contexto
+ * cuyo puntero de pila es restaurar.
+ */
+void cambiar_contexto_hu(void **guardar, void *restaurar)
+	__attribute__((visibility("hidden")));
+
+#if defined(__x86_64__)
+__asm__(
+	".text\n"
+	".globl cambiar_contexto_hu\n"
+	".hidden cambiar_contexto_hu\n"
+	".type cambiar_contexto_hu, @function\n"
+	"cambiar_contexto_hu:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	".size cambiar_contexto_hu, .-cambiar_contexto_hu\n");
+#define REGS_SALVADOS 6
+#else
+__asm__(
+	".text\n"
+	".globl cambiar_contexto_hu\n"
+	".hidden cambiar_contexto_hu\n"
+	".type cambiar_contexto_hu, @function\n"
+	"cambiar_contexto_hu:\n"
+	"	movl 4(%esp), %eax\n"
+	"	movl 8(%esp), %edx\n"
+	"	pushl %ebp\n"
+	"	pushl %ebx\n"
+	"	pushl %esi\n"
+	"	pushl %edi\n"
+	"	movl %esp, (%eax)\n"
+	"	movl %edx, %esp\n"
+	"	popl %edi\n"
+	"	popl %esi\n"
+	"	popl %ebx\n"
+	"	popl %ebp\n"
+	"	ret\n"
+	".size cambiar_contexto_hu, .-cambiar_contexto_hu\n");
+#define REGS_SALVADOS 4
+#endif
+
+//Si el cerrojo esta cogido su dueno es otro portador: se le cede la UCP
+static void adquirir() {
+	while (__sync_lock_test_and_set(&cerrojo, 1))
+		ceder_procesador();
+}
+
+static void soltar() {
+	__sync_lock_release(&cerrojo);
+}
+
+static void meter(hu_cola *cola, struct hu_hilo *h) {
+	h->siguiente = NULL;
+	if (cola->ultimo == NULL)
+		cola->primero = h;
+	else
+		cola->ultimo->siguiente = h;
+	cola->ultimo = h;
+}
+
+static struct hu_hilo *sacar(hu_cola *cola) {
+	struct hu_hilo *h = cola->primero;
+
+	if (h != NULL) {
+		cola->primero = h->siguiente;
+		if (cola->primero == NULL)
+			cola->ultimo = NULL;
+	}
+	return h;
+}
+
+static void listo(struct hu_hilo *h) {
+	h->estado = LISTO;
+	meter(&listos, h);
+}
+
+//El hilo actual es aquel en cuya pila esta la variable local (NULL fuera)
+static struct hu_hilo *hilo_actual() {
+	char marca;
+	unsigned long desp = (unsigned long)&marca - (unsigned long)pilas;
+
+	if (desp >= sizeof(pilas))
+		return NULL;
+	return &hilos[desp / TAM_PILA_HU];
+}
+
+/*
+ * Deja el hilo actual en el estado indicado y vuelve a su portador. Debe
+ * llamarse con el cerrojo cogido; al continuar el hilo (quiza en otro
+ * portador) se suelta.
+ */
+static void parar(struct hu_hilo *h, int estado) {
+	h->estado = estado;
+	cambiar_contexto_hu(&h->sp, h->portador->sp);
+	soltar();
+}
+
+//Primera funcion de un hilo: llega con el cerrojo que cogio el portador
+static void arranque() {
+	struct hu_hilo *h = hilo_actual();
+
+	soltar();
+	h->funcion(h->argumento);
+	hu_terminar();
+}
+
+//Pila inicial de un hilo: como si cambiar_contexto_hu hubiera sido
+//llamado desde arranque, con la alineacion que espera una funcion
+static void *preparar_pila(int i) {
+	void **sp = (void **)(pilas[i] + TAM_PILA_HU);
+	int r;
+
+	*--sp = NULL;
+	*--sp = (void *)arranque;
+	for (r = 0; r < REGS_SALVADOS; r++)
+		*--sp = NULL;
+	return sp;
+}
+
+static int hay_caracter() {
+	struct evento ev = {EVENTO_TERMINAL, 0};
+
+	return esperar_multiple(&ev, 1, 0) >= 0;
+}
+
+//Pasa a listos los dormidos cuyo plazo ha vencido y un hilo que espere
+//al terminal si hay caracteres. Con el cerrojo cogido
+static void revisar_esperas() {
+	struct hu_hilo *h;
+	hu_cola quedan = {NULL, NULL};
+	int ahora;
+
+	if (dormidos.primero != NULL) {
+
+		ahora = tiempos_proceso(0);
+		while ((h = sacar(&dormidos)) != NULL)
+			if (h->despertar <= ahora)
+				listo(h);
+			else
+				meter(&quedan, h);
+		dormidos = quedan;
+	}
+
+	if ((terminal.primero != NULL) && hay_caracter())
+		listo(sacar(&terminal));
+}
+
+//Sin hilos listos: si hay hilos esperando tiempo o terminal el portador
+//se bloquea un rato en el kernel; si no, los demas portadores estan
+//ejecutando hilos y solo se cede la UCP. Sin el cerrojo cogido
+static void esperar_trabajo() {
+	struct evento ev = {EVENTO_TERMINAL, 0};
+
+	if (terminal.primero != NULL)
+		esperar_multiple(&ev, 1, ESPERA_HU_MS);
+	else if (dormidos.primero != NULL)
+		esperar_multiple(NULL, 0, ESPERA_HU_MS);
+	else
+		ceder_procesador();
+}
+
+//Bucle de cada portador: ejecuta hilos listos hasta que no quede ninguno
+static int bucle_portador(void *arg) {
+	struct portador *yo = arg;
+	struct hu_hilo *h;
+	int despachos = 0;
+
+	adquirir();
+	while (vivos > 0) {
+
+		if ((listos.primero == NULL) || (++despachos % REVISION_HU == 0))
+			revisar_esperas();
+
+		h = sacar(&listos);
+		if (h == NULL) {
+
+			soltar();
+			esperar_trabajo();
+			adquirir();
+			continue;
+		}
+
+		h->estado = EJECUTANDO;
+		h->portador = yo;
+		cambiar_contexto_hu(&yo->sp, h->sp);
+
+		//Ya no se ejecuta sobre su pila: se puede reutilizar
+		if (h->estado == TERMINADO) {
+
+			h->estado = LIBRE;
+			vivos--;
+		}
+	}
+	soltar();
+	return 0;
+}
+
+///////////////////////////
+// FUNCIONES DE SERVICIO //
+///////////////////////////
+
+int hu_crear(void (*funcion)(void *), void *argumento) {
+	int i;
+
+	adquirir();
+	for (i = 0; (i < MAX_HILOS_USUARIO) && (hilos[i].estado != LIBRE); i++);
+	if (i == MAX_HILOS_USUARIO) {
+
+		soltar();
+		return -1;
+	}
+
+	hilos[i].funcion = funcion;
+	hilos[i].argumento = argumento;
+	hilos[i].sp = preparar_pila(i);
+	vivos++;
+	listo(&hilos[i]);
+	soltar();
+	return i;
+}
+
+int hu_ejecutar(int n_portadores) {
+	int pids[MAX_PORTADORES];
+	int i;
+
+	if ((hilo_actual() != NULL) || (n_portadores < 1) || (n_portadores > MAX_PORTADORES))
+		return -1;
+
+	//Si no se puede crear algun portador se sigue con menos
+	for (i = 1; i < n_portadores; i++)
+		pids[i] = crear_hilo(bucle_portador, &portadores[i]);
+
+	bucle_portador(&portadores[0]);
+
+	for (i = 1; i < n_portadores; i++)
+		if (pids[i] >= 0)
+			esperar_hilo(pids[i], 0);
+	return 0;
+}
+
+void hu_ceder() {
+	struct hu_hilo *h = hilo_actual();
+
+	if (h == NULL)
+		return;
+
+	adquirir();
+	meter(&listos, h);
+	parar(h, LISTO);
+}
+
+void hu_terminar() {
+	struct hu_hilo *h = hilo_actual();
+
+	if (h == NULL)
+		return;
+
+	//El portador libera el hilo cuando ya no usa su pila
+	adquirir();
+	h->estado = TERMINADO;
+	cambiar_contexto_hu(&h->sp, h->portador->sp);
+}
+
+void hu_dormir(int ms) {
+	struct hu_hilo *h = hilo_actual();
+
+	if (h == NULL) {
+
+		esperar_multiple(NULL, 0, ms);
+		return;
+	}
+
+	adquirir();
+	h->despertar = tiempos_proceso(0) + (ms * TICKS_SEG + 999) / 1000;
+	meter(&dormidos, h);
+	parar(h, DORMIDO);
+}
+
+//Solo bloquea al portador si otro hilo se adelanta a leer el caracter
+int hu_leer_caracter() {
+	struct hu_hilo *h = hilo_actual();
+
+	if (h != NULL)
+		while (!hay_caracter()) {
+
+			adquirir();
+			meter(&terminal, h);
+			parar(h, TERMINAL);
+		}
+	return leer_caracter();
+}
+
+void hu_mutex_iniciar(hu_mutex *m) {
+	m->propietario = NULL;
+	m->esperando.primero = m->esperando.ultimo = NULL;
+}
+
+int hu_mutex_lock(hu_mutex *m) {
+	struct hu_hilo *h = hilo_actual();
+
+	if (h == NULL)
+		return -1;
+
+	adquirir();
+	if (m->propietario == h) {
+
+		soltar();
+		return -1;
+	}
+
+	//Si esta cogido unlock traspasa la propiedad al despertarlo
+	if (m->propietario == NULL) {
+
+		m->propietario = h;
+		soltar();
+	}
+	else {
+
+		meter(&m->esperando, h);
+		parar(h, BLOQUEADO);
+	}
+	return 0;
+}
+
+//Con el cerrojo cogido
+static void liberar_mutex_hu(hu_mutex *m) {
+	m->propietario = sacar(&m->esperando);
+	if (m->propietario != NULL)
+		listo(m->propietario);
+}
+
+int hu_mutex_unlock(hu_mutex *m) {
+	struct hu_hilo *h = hilo_actual();
+
+	adquirir();
+	if ((h == NULL) || (m->propietario != h)) {
+
+		soltar();
+		return -1;
+	}
+	liberar_mutex_hu(m);
+	soltar();
+	return 0;
+}
+
+void hu_cond_iniciar(hu_cond *c) {
+	c->esperando.primero = c->esperando.ultimo = NULL;
+}
+
+int hu_cond_esperar(hu_cond *c, hu_mutex *m) {
+	struct hu_hilo *h = hilo_actual();
+
+	adquirir();
+	if ((h == NULL) || (m->propietario != h)) {
+
+		soltar();
+		return -1;
+	}
+
+	//Soltar el mutex y esperar es atomico respecto a senalar
+	liberar_mutex_hu(m);
+	meter(&c->esperando, h);
+	parar(h, BLOQUEADO);
+
+	return hu_mutex_lock(m);
+}
+
+void hu_cond_senalar(hu_cond *c) {
+	struct hu_hilo *h;
+
+	adquirir();
+	if ((h = sacar(&c->esperando)) != NULL)
+		listo(h);
+	soltar();
+}
+
+void hu_cond_difundir(hu_cond *c) {
+	struct hu_hilo *h;
+
+	adquirir();
+	while ((h = sacar(&c->esperando)) != NULL)
+		listo(h);
+	soltar();
+}
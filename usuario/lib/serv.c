@@ -37,8 +37,17 @@ int llamsis(int llamada, int nargs, ... /* args */);
 int crear_proceso(char *prog){
 	return llamsis(CREAR_PROCESO, 1, (long)prog);
 }
+int crear_proceso_con_pila(char *prog, int tam_pila){
+	return llamsis(CREAR_PROCESO_CON_PILA, 2, (long)prog, (long)tam_pila);
+}
+int crear_proceso_esperando(char *prog, int timeout){
+	return llamsis(CREAR_PROCESO_ESPERANDO, 2, (long)prog, (long)timeout);
+}
+int crear_procesos(char *prog, int n, int *pids){
+	return llamsis(CREAR_PROCESOS, 3, (long)prog, (long)n, (long)pids);
+}
 int terminar_proceso(){
-	return llamsis(TERMINAR_PROCESO, 0);
+	return llamsis(TERMINAR_PROCESO, 1, 0L);
 }
 int escribir(char *texto, unsigned int longi){
 	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
@@ -49,6 +58,9 @@ int obtener_id_pr(){
 int dormir(unsigned int segundos){
 	return llamsis(DORMIR, 1, (long)segundos);
 }
+int tiempos_proceso(struct tiempos_ejec *t_ejec){
+	return llamsis(TIEMPOS_PROCESO, 1, (long)t_ejec);
+}
 
 //MUTEX
 int crear_mutex(char* nombre, int tipo) {
@@ -66,3 +78,281 @@ int unlock(unsigned int mutexid) {
 int cerrar_mutex(unsigned int mutexid) {
 	return llamsis(CERRAR_MUTEX, 1, (long)mutexid);
 }
+int estadisticas_mutex(unsigned int mutexid, struct estad_mutex *est) {
+	return llamsis(ESTADISTICAS_MUTEX, 2, (long)mutexid, (long)est);
+}
+
+//SEMAFOROS
+int crear_sem(char* nombre, unsigned int valor) {
+	return llamsis(CREAR_SEM, 2, (long)nombre, (long)valor);
+}
+int abrir_sem(char* nombre) {
+	return llamsis(ABRIR_SEM, 1, (long)nombre);
+}
+int esperar_sem(unsigned int semid) {
+	return llamsis(ESPERAR_SEM, 1, (long)semid);
+}
+int senalar_sem(unsigned int semid) {
+	return llamsis(SENALAR_SEM, 1, (long)semid);
+}
+int cerrar_sem(unsigned int semid) {
+	return llamsis(CERRAR_SEM, 1, (long)semid);
+}
+
+//VARIABLES CONDICION
+int crear_cond(char* nombre) {
+	return llamsis(CREAR_COND, 1, (long)nombre);
+}
+int abrir_cond(char* nombre) {
+	return llamsis(ABRIR_COND, 1, (long)nombre);
+}
+int esperar_cond(unsigned int condid, unsigned int mutexid) {
+	return llamsis(ESPERAR_COND, 2, (long)condid, (long)mutexid);
+}
+int senalar_cond(unsigned int condid) {
+	return llamsis(SENALAR_COND, 1, (long)condid);
+}
+int difundir_cond(unsigned int condid) {
+	return llamsis(DIFUNDIR_COND, 1, (long)condid);
+}
+int cerrar_cond(unsigned int condid) {
+	return llamsis(CERRAR_COND, 1, (long)condid);
+}
+
+//CERROJOS LECTORES/ESCRITORES
+int crear_cerrojo(char* nombre, int preferencia) {
+	return llamsis(CREAR_CERROJO, 2, (long)nombre, (long)preferencia);
+}
+int abrir_cerrojo(char* nombre) {
+	return llamsis(ABRIR_CERROJO, 1, (long)nombre);
+}
+int lock_lectura(unsigned int cerrojoid) {
+	return llamsis(LOCK_LECTURA, 1, (long)cerrojoid);
+}
+int lock_escritura(unsigned int cerrojoid) {
+	return llamsis(LOCK_ESCRITURA, 1, (long)cerrojoid);
+}
+int unlock_cerrojo(unsigned int cerrojoid) {
+	return llamsis(UNLOCK_CERROJO, 1, (long)cerrojoid);
+}
+int cerrar_cerrojo(unsigned int cerrojoid) {
+	return llamsis(CERRAR_CERROJO, 1, (long)cerrojoid);
+}
+
+//BARRERAS
+int crear_barrera(char* nombre, unsigned int participantes) {
+	return llamsis(CREAR_BARRERA, 2, (long)nombre, (long)participantes);
+}
+int abrir_barrera(char* nombre) {
+	return llamsis(ABRIR_BARRERA, 1, (long)nombre);
+}
+int esperar_barrera(unsigned int barreraid) {
+	return llamsis(ESPERAR_BARRERA, 1, (long)barreraid);
+}
+int cerrar_barrera(unsigned int barreraid) {
+	return llamsis(CERRAR_BARRERA, 1, (long)barreraid);
+}
+
+//TERMINAL
+int leer_caracter() {
+	return llamsis(LEER_CARACTER, 0);
+}
+
+//ESPERA MULTIPLE
+int esperar_multiple(struct evento *eventos, int n, int timeout) {
+	return llamsis(ESPERAR_MULTIPLE, 3, (long)eventos, (long)n, (long)timeout);
+}
+
+//VARIOS MUTEX
+int lock_varios(unsigned int *descs, int n) {
+	return llamsis(LOCK_VARIOS, 2, (long)descs, (long)n);
+}
+int unlock_varios(unsigned int *descs, int n) {
+	return llamsis(UNLOCK_VARIOS, 2, (long)descs, (long)n);
+}
+
+//TUBERIAS
+int crear_tuberia(int descs[2]) {
+	return llamsis(CREAR_TUBERIA, 1, (long)descs);
+}
+int leer_tuberia(unsigned int desc, void *buf, int tam) {
+	return llamsis(LEER_TUBERIA, 3, (long)desc, (long)buf, (long)tam);
+}
+int escribir_tuberia(unsigned int desc, void *buf, int tam) {
+	return llamsis(ESCRIBIR_TUBERIA, 3, (long)desc, (long)buf, (long)tam);
+}
+int cerrar_tuberia(unsigned int desc) {
+	return llamsis(CERRAR_TUBERIA, 1, (long)desc);
+}
+
+//MEMORIA COMPARTIDA
+int crear_segmento(char *nombre, int tam, void **dir) {
+	return llamsis(CREAR_SEGMENTO, 3, (long)nombre, (long)tam, (long)dir);
+}
+int asociar_segmento(char *nombre, void **dir, int *tam) {
+	return llamsis(ASOCIAR_SEGMENTO, 3, (long)nombre, (long)dir, (long)tam);
+}
+int desasociar_segmento(unsigned int segid) {
+	return llamsis(DESASOCIAR_SEGMENTO, 1, (long)segid);
+}
+
+//MENSAJES
+int enviar(int pid, void *msg, int tam) {
+	return llamsis(ENVIAR, 3, (long)pid, (long)msg, (long)tam);
+}
+int recibir(int *pid, void *msg, int tam) {
+	return llamsis(RECIBIR, 3, (long)pid, (long)msg, (long)tam);
+}
+int llamar(int pid, void *msg, int tam) {
+	return llamsis(LLAMAR, 3, (long)pid, (long)msg, (long)tam);
+}
+int responder(int pid, void *msg, int tam) {
+	return llamsis(RESPONDER, 3, (long)pid, (long)msg, (long)tam);
+}
+int responder_y_recibir(int *pid, void *msg, int tam) {
+	return llamsis(RESPONDER_Y_RECIBIR, 3, (long)pid, (long)msg, (long)tam);
+}
+
+//AVISOS
+//Manejador del programa. Las instancias de un mismo programa comparten
+//esta variable, pero todas registran la misma funcion
+static void (*manejador_avisos)(int avisos);
+
+//El kernel empieza a ejecutar aqui, en una pila aparte, cuando hay que
+//entregar avisos. fin_avisos no retorna: se vuelve a donde estaba el proceso
+static void entrada_avisos() {
+	manejador_avisos(llamsis(TOMAR_AVISOS, 0));
+	llamsis(FIN_AVISOS, 0);
+}
+
+int registrar_avisos(void (*manejador)(int avisos)) {
+	manejador_avisos = manejador;
+	return llamsis(REGISTRAR_AVISOS, 1, (long)(manejador ? entrada_avisos : 0));
+}
+int notificar(int pid, int avisos) {
+	return llamsis(NOTIFICAR, 2, (long)pid, (long)avisos);
+}
+int esperar_avisos() {
+	return llamsis(ESPERAR_AVISOS, 0);
+}
+int alarma_aviso(int ms) {
+	return llamsis(ALARMA_AVISO, 1, (long)ms);
+}
+
+//FICHEROS
+int abrir(char *ruta, int modo) {
+	return llamsis(ABRIR, 2, (long)ruta, (long)modo);
+}
+int leer_fichero(unsigned int fd, void *buf, int tam) {
+	return llamsis(LEER_FICHERO, 3, (long)fd, (long)buf, (long)tam);
+}
+int escribir_fichero(unsigned int fd, void *buf, int tam) {
+	return llamsis(ESCRIBIR_FICHERO, 3, (long)fd, (long)buf, (long)tam);
+}
+int posicionar(unsigned int fd, int desp, int origen) {
+	return llamsis(POSICIONAR, 3, (long)fd, (long)desp, (long)origen);
+}
+int cerrar_fichero(unsigned int fd) {
+	return llamsis(CERRAR_FICHERO, 1, (long)fd);
+}
+int crear_directorio(char *ruta) {
+	return llamsis(CREAR_DIRECTORIO, 1, (long)ruta);
+}
+int borrar(char *ruta) {
+	return llamsis(BORRAR, 1, (long)ruta);
+}
+
+//DISCO
+int leer_bloque(int bloque, void *buf) {
+	return llamsis(LEER_BLOQUE, 2, (long)bloque, (long)buf);
+}
+int escribir_bloque(int bloque, void *buf) {
+	return llamsis(ESCRIBIR_BLOQUE, 2, (long)bloque, (long)buf);
+}
+int sincronizar() {
+	return llamsis(SINCRONIZAR, 0);
+}
+int ajustar_cache(int buffers) {
+	return llamsis(AJUSTAR_CACHE, 1, (long)buffers);
+}
+int estadisticas_disco(struct estad_disco *estad) {
+	return llamsis(ESTADISTICAS_DISCO, 1, (long)estad);
+}
+
+//REGIONES
+int crear_region(int tam, void **dir) {
+	return llamsis(CREAR_REGION, 2, (long)tam, (long)dir);
+}
+int transferir_region(unsigned int des, int pid) {
+	return llamsis(TRANSFERIR_REGION, 2, (long)des, (long)pid);
+}
+int recibir_region(void **dir, int *tam, int *pid) {
+	return llamsis(RECIBIR_REGION, 3, (long)dir, (long)tam, (long)pid);
+}
+int liberar_region(unsigned int des) {
+	return llamsis(LIBERAR_REGION, 1, (long)des);
+}
+
+//ESPERA DE HIJOS
+int esperar_proceso(int pid, int *estado) {
+	return llamsis(ESPERAR_PROCESO, 2, (long)pid, (long)estado);
+}
+int esperar_hijo(int *estado) {
+	return llamsis(ESPERAR_PROCESO, 2, -1L, (long)estado);
+}
+int terminar_con_estado(int estado) {
+	return llamsis(TERMINAR_PROCESO, 1, (long)estado);
+}
+
+//CACHE DE IMAGENES
+int ajustar_cache_imagenes(int n) {
+	return llamsis(AJUSTAR_CACHE_IMAGENES, 1, (long)n);
+}
+int estadisticas_imagenes(struct estad_imagenes *estad) {
+	return llamsis(ESTADISTICAS_IMAGENES, 1, (long)estad);
+}
+
+//RESERVA DE PILAS
+int ajustar_pilas(int n) {
+	return llamsis(AJUSTAR_PILAS, 1, (long)n);
+}
+int estadisticas_pilas(struct estad_pilas *estad) {
+	return llamsis(ESTADISTICAS_PILAS, 1, (long)estad);
+}
+
+//RECLAMO DE PILAS
+int ajustar_reclamo(int ticks) {
+	return llamsis(AJUSTAR_RECLAMO, 1, (long)ticks);
+}
+int estadisticas_reclamo(struct estad_reclamo *estad) {
+	return llamsis(ESTADISTICAS_RECLAMO, 1, (long)estad);
+}
+
+//USO DE PILA
+int uso_pila(char *prog, struct uso_pila *uso) {
+	return llamsis(USO_PILA, 2, (long)prog, (long)uso);
+}
+
+//HILOS
+//Primera funcion que ejecuta un hilo: recoge la funcion y su argumento
+static void entrada_hilo() {
+	int (*funcion)(void *);
+	void *argumento;
+
+	llamsis(TOMAR_HILO, 2, (long)&funcion, (long)&argumento);
+	terminar_hilo(funcion(argumento));
+}
+int crear_hilo(int (*funcion)(void *), void *argumento) {
+	return llamsis(CREAR_HILO, 3, (long)entrada_hilo, (long)funcion, (long)argumento);
+}
+int terminar_hilo(int valor) {
+	return llamsis(TERMINAR_PROCESO, 1, (long)valor);
+}
+int esperar_hilo(int pid, int *valor) {
+	return llamsis(ESPERAR_HILO, 2, (long)pid, (long)valor);
+}
+
+//CESION DEL PROCESADOR
+int ceder_procesador() {
+	return llamsis(CEDER_PROCESADOR, 0);
+}
@@ -0,0 +1,29 @@
+/*
+ * usuario/notificador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de los avisos: manda
+ * tres avisos seguidos a prueba_avisos, cuyo pid lee de la tuberia
+ * heredada
+ */
+
+#include "servicios.h"
+
+int main(){
+	int pid;
+
+	leer_tuberia(0, &pid, sizeof(pid));
+
+	notificar(pid, 1);
+	notificar(pid, 2);
+	notificar(pid, 4);
+	printf("notificador: enviados los avisos 1, 2 y 4\n");
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*
+ * usuario/participante.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de las barreras
+ */
+
+#include "servicios.h"
+
+#define NUM_FASES 3
+
+int main(){
+	int desc, id, i;
+
+	id=obtener_id_pr();
+
+	if ((desc=abrir_barrera("fases"))<0)
+		printf("error abriendo fases. NO DEBE APARECER\n");
+
+	for (i=1; i<=NUM_FASES; i++) {
+		printf("participante (%d) llega a la fase %d en tick %d\n", id, i,
+			tiempos_proceso(0));
+		if (esperar_barrera(desc)<0)
+			printf("error en esperar_barrera. NO DEBE APARECER\n");
+		printf("participante (%d) sale de la fase %d en tick %d\n", id, i,
+			tiempos_proceso(0));
+	}
+
+	printf("participante (%d) termina\n", id);
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*
+ * usuario/productor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de las tuberias:
+ * escribe en la tuberia heredada TOTAL bytes con cada tamano de mensaje
+ */
+
+#include "servicios.h"
+
+#define TOTAL (4*1024*1024)
+#define TUB_LECTURA 0	/* descriptores heredados de prueba_tuberia */
+#define TUB_ESCRITURA 1
+
+static int tamanos[]={16, 256, 4096, 16384};
+static char buf[16384];
+
+int main(){
+	int i, j;
+
+	/* el extremo de lectura es del padre */
+	cerrar_tuberia(TUB_LECTURA);
+
+	for (i=0; i<sizeof(tamanos)/sizeof(int); i++)
+		for (j=0; j<TOTAL; j+=tamanos[i])
+			if (escribir_tuberia(TUB_ESCRITURA, buf, tamanos[i])!=tamanos[i])
+				printf("productor: error escribiendo. NO DEBE APARECER\n");
+
+	/* al terminar se cierra el extremo de escritura: fin de fichero */
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * usuario/profundo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba del tamano de pila:
+ * ocupa unos 128 KB de pila en llamadas recursivas. Con la pila por
+ * defecto alcanza la pagina de guarda y el kernel lo aborta.
+ */
+
+#include "servicios.h"
+
+#define NIVELES 128
+
+static int bajar(int nivel) {
+	volatile char marco[1024];
+
+	marco[0]=1;
+	if (nivel==NIVELES)
+		return marco[0];
+	return bajar(nivel+1)+marco[0];
+}
+
+int main(){
+	terminar_con_estado(bajar(1)==NIVELES ? 1 : 2);
+	return 0;
+}
@@ -22,7 +22,9 @@ int main(){
 	for (i=1; i<=5; i++)
 		if (crear_proceso("yosoy")<0)
 			printf("Error creando yosoy\n");
-	
+
+	/* termina cuando lo han hecho todos los yosoy */
+	while (esperar_hijo(0)>=0);
 
 	printf("prueba_RR1: termina\n");
 	return 0; 
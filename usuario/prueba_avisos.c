@@ -0,0 +1,55 @@
+/*
+ * usuario/prueba_avisos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los avisos asincronos:
+ * recibe en una sola entrega los avisos que manda notificador y despues
+ * una alarma mientras esta calculando, sin hacer llamadas al sistema.
+ */
+
+#include "servicios.h"
+
+static volatile int recibidos;
+static int entregas;
+
+static void manejador(int avisos) {
+	entregas++;
+	recibidos|=avisos;
+	printf("prueba_avisos: entrega %d con avisos %x en tick %d\n", entregas,
+		avisos, tiempos_proceso(0));
+}
+
+int main(){
+	int tub[2];
+	int pid, i;
+
+	printf("prueba_avisos comienza\n");
+
+	if (registrar_avisos(manejador)<0)
+		printf("error registrando manejador. NO DEBE APARECER\n");
+	if (notificar(obtener_id_pr(), AVISO_ALARMA)>=0)
+		printf("se envia un aviso del kernel. NO DEBE APARECER\n");
+
+	crear_tuberia(tub);
+	if (crear_proceso("notificador")<0)
+		printf("Error creando notificador\n");
+	pid=obtener_id_pr();
+	escribir_tuberia(tub[1], &pid, sizeof(pid));
+
+	/* los tres avisos llegan en una sola entrega (DEBE SER 7) */
+	esperar_avisos();
+
+	/* la alarma interrumpe el bucle al volver de una expulsion */
+	alarma_aviso(300);
+	for (i=0; !(recibidos & AVISO_ALARMA); i++);
+	printf("prueba_avisos: alarma tras %d vueltas de calculo\n", i);
+
+	printf("prueba_avisos termina con %d entregas\n", entregas);
+	return 0;
+}
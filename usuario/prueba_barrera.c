@@ -0,0 +1,46 @@
+/*
+ * usuario/prueba_barrera.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las barreras: este
+ * proceso y 3 procesos participante sincronizan 3 fases con la barrera
+ * "fases". Todos deben salir de cada fase en el mismo tick.
+ */
+
+#include "servicios.h"
+
+#define NUM_PARTICIPANTES 3
+#define NUM_FASES 3
+
+int main(){
+	int desc, i;
+
+	printf("prueba_barrera comienza\n");
+
+	if (crear_barrera("fases", 0)<0)
+		printf("error creando barrera sin participantes. DEBE APARECER\n");
+
+	if ((desc=crear_barrera("fases", NUM_PARTICIPANTES+1))<0)
+		printf("error creando fases. NO DEBE APARECER\n");
+
+	for (i=0; i<NUM_PARTICIPANTES; i++)
+		if (crear_proceso("participante")<0)
+			printf("Error creando participante\n");
+
+	/* es el que mas tarda en llegar a cada fase */
+	for (i=1; i<=NUM_FASES; i++) {
+		dormir(1);
+		esperar_barrera(desc);
+		printf("prueba_barrera sale de la fase %d en tick %d\n", i,
+			tiempos_proceso(0));
+	}
+
+	printf("prueba_barrera termina\n");
+	return 0;
+}
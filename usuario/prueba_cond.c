@@ -0,0 +1,52 @@
+/*
+ * usuario/prueba_cond.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las variables condicion
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, i;
+
+	printf("prueba_cond comienza\n");
+
+	if ((mut=crear_mutex("mc", NO_RECURSIVO))<0)
+		printf("error creando mc. NO DEBE APARECER\n");
+
+	if ((cond=crear_cond("cc"))<0)
+		printf("error creando cc. NO DEBE APARECER\n");
+
+	/* no tiene el mutex -> error */
+	if (esperar_cond(cond, mut)<0)
+		printf("esperar_cond sin tener el mutex. DEBE APARECER\n");
+
+	for (i=1; i<=3; i++)
+		if (crear_proceso("esperador")<0)
+			printf("Error creando esperador\n");
+
+	printf("prueba_cond duerme 1 seg.: los esperadores se bloquearan en cc\n");
+	dormir(1);
+
+	lock(mut);
+	printf("prueba_cond senala cc: debe despertar solo un esperador\n");
+	senalar_cond(cond);
+	unlock(mut);
+	dormir(1);
+
+	lock(mut);
+	printf("prueba_cond difunde cc: deben despertar los otros dos\n");
+	difundir_cond(cond);
+	unlock(mut);
+	dormir(1);
+
+	printf("prueba_cond termina\n");
+	return 0;
+}
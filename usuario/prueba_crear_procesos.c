@@ -0,0 +1,65 @@
+/*
+ * usuario/prueba_crear_procesos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara crear procesos de uno en uno con
+ * crear_proceso y en grupos con crear_procesos. En cada ronda crea un
+ * grupo de instancias de efimero y espera a que terminen todas.
+ */
+
+#include "servicios.h"
+
+#define GRUPO 100
+#define RONDAS 100
+#define US_TICK 10000		/* microsegundos por tick del kernel */
+
+static void medir(char *nombre, int en_grupo) {
+	int pids[GRUPO];
+	int i, j, t0, t1;
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<RONDAS; i++) {
+		if (en_grupo) {
+			if (crear_procesos("efimero", GRUPO, pids)!=GRUPO)
+				printf("Error creando el grupo de efimero\n");
+		}
+		else
+			for (j=0; j<GRUPO; j++)
+				if ((pids[j]=crear_proceso("efimero"))<0)
+					printf("Error creando efimero\n");
+		for (j=0; j<GRUPO; j++)
+			esperar_proceso(pids[j], 0);
+	}
+	t1=tiempos_proceso(0);
+
+	if (t1==t0)
+		t1++;
+	printf("%s: %d procesos/s\n", nombre,
+		RONDAS*GRUPO*(1000000/US_TICK)/(t1-t0));
+}
+
+int main(){
+	int pids[2];
+
+	printf("prueba_crear_procesos comienza\n");
+
+	if (crear_procesos("efimero", 0, pids)>=0)
+		printf("grupo vacio. NO DEBE APARECER\n");
+	if (crear_procesos("no_existe", 2, pids)>=0)
+		printf("programa inexistente. NO DEBE APARECER\n");
+
+	/* el programa queda en la cache de imagenes en ambas medidas */
+	esperar_proceso(crear_proceso("efimero"), 0);
+
+	medir("de uno en uno", 0);
+	medir("en grupos", 1);
+
+	printf("prueba_crear_procesos termina\n");
+	return 0;
+}
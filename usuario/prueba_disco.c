@@ -0,0 +1,113 @@
+/*
+ * usuario/prueba_disco.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el disco y su cache de bloques: escribe
+ * una zona del disco, comprueba su contenido y mide el rendimiento y la
+ * latencia de lecturas secuenciales y aleatorias con distintos tamanos de
+ * cache. Tambien reescribe un bloque durante varios periodos de volcado y
+ * comprueba que en el disco queda la ultima version.
+ */
+
+#include "servicios.h"
+
+#define TAM_BLOQUE 4096
+#define ZONA 1024		/* bloques usados en las medidas (4 MB) */
+#define ACCESOS 8192		/* lecturas en cada medida */
+#define TICKS_SEG 100		/* valor de TICK en el kernel */
+#define TICKS_VOLCADO 100	/* valor de TICKS_VOLCADO en el kernel */
+#define PERIODOS 5		/* de volcado reescribiendo el mismo bloque */
+
+static int caches[]={16, 64, 256};
+static int buf[TAM_BLOQUE/sizeof(int)];
+static unsigned int semilla=1;
+
+static int aleatorio() {
+	semilla=semilla*1103515245+12345;
+	return (semilla>>16)%ZONA;
+}
+
+static void medir(char *tipo, int cache, int t0, int t1) {
+	struct estad_disco e;
+	int ticks=(t1>t0) ? t1-t0 : 1;
+
+	estadisticas_disco(&e);
+	printf("%-10s cache %3d: %5d KB/s, %5d us/bloque, aciertos %4d, fallos %4d, adelantadas %4d, lecturas %4d\n",
+		tipo, cache, ACCESOS*(TAM_BLOQUE/1024)/ticks*TICKS_SEG,
+		ticks*(1000000/TICKS_SEG)/ACCESOS, e.aciertos, e.fallos,
+		e.adelantadas, e.lecturas);
+}
+
+int main(){
+	int i, j, t0, t1, n, errores=0;
+	struct estad_disco e;
+
+	printf("prueba_disco comienza\n");
+
+	/* cada bloque lleva su numero: se escriben con cache minima para
+	   forzar la escritura diferida al expulsarlos */
+	ajustar_cache(16);
+	for (i=0; i<ZONA; i++) {
+		buf[0]=i;
+		escribir_bloque(i, buf);
+	}
+	sincronizar();
+	estadisticas_disco(&e);
+	printf("escritos %d bloques, %d escrituras en disco\n", ZONA, e.escrituras);
+
+	ajustar_cache(64);
+	for (i=ZONA-1; i>=0; i--) {
+		leer_bloque(i, buf);
+		if (buf[0]!=i)
+			errores++;
+	}
+	printf("bloques con contenido erroneo: %d\n", errores);
+
+	/* los volcados periodicos coinciden con escrituras del bloque */
+	t0=tiempos_proceso(0);
+	for (n=0; tiempos_proceso(0)-t0<PERIODOS*TICKS_VOLCADO; n++) {
+		for (j=0; j<TAM_BLOQUE/sizeof(int); j++)
+			buf[j]=n;
+		escribir_bloque(0, buf);
+	}
+	sincronizar();
+	ajustar_cache(64);	/* vacia la cache: se lee del disco */
+	leer_bloque(0, buf);
+	errores=0;
+	for (j=0; j<TAM_BLOQUE/sizeof(int); j++)
+		if (buf[j]!=n-1)
+			errores++;
+	printf("bloque reescrito %d veces: %d palabras erroneas\n", n, errores);
+
+	if (leer_bloque(-1, buf)>=0)
+		printf("se lee un bloque fuera del disco. NO DEBE APARECER\n");
+
+	for (i=0; i<sizeof(caches)/sizeof(int); i++) {
+		ajustar_cache(caches[i]);
+		estadisticas_disco(0);
+		t0=tiempos_proceso(0);
+		for (j=0; j<ACCESOS; j++)
+			leer_bloque(j%ZONA, buf);
+		t1=tiempos_proceso(0);
+		medir("secuencial", caches[i], t0, t1);
+
+		/* la zona de acceso aleatorio es la cuarta parte de la de
+		   medida: la tasa de aciertos depende del tamano de la cache */
+		ajustar_cache(caches[i]);
+		estadisticas_disco(0);
+		t0=tiempos_proceso(0);
+		for (j=0; j<ACCESOS; j++)
+			leer_bloque(aleatorio()/4, buf);
+		t1=tiempos_proceso(0);
+		medir("aleatorio", caches[i], t0, t1);
+	}
+
+	printf("prueba_disco termina\n");
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * usuario/prueba_esperar.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la espera por procesos hijos: espera a
+ * un hijo concreto mientras otros terminan antes, recoge los demas con la
+ * variante que espera a cualquiera, recoge el estado de un hijo abortado
+ * por una excepcion y el de uno que termino mucho antes de esperarlo.
+ */
+
+#include "servicios.h"
+
+#define HIJOS 3
+
+int main(){
+	int i, pid, estado, pids[HIJOS];
+
+	printf("prueba_esperar comienza\n");
+
+	/* cada saliente termina con su pid por 10 como estado */
+	for (i=0; i<HIJOS; i++)
+		if ((pids[i]=crear_proceso("saliente"))<0)
+			printf("Error creando saliente\n");
+
+	pid=esperar_proceso(pids[HIJOS-1], &estado);
+	printf("terminado el ultimo hijo %d con estado %d\n", pid, estado);
+	if ((pid!=pids[HIJOS-1]) || (estado!=pid*10))
+		printf("estado erroneo. NO DEBE APARECER\n");
+
+	/* los demas ya son zombis: salen en el orden en que terminaron */
+	while ((pid=esperar_hijo(&estado))>=0) {
+		printf("terminado el hijo %d con estado %d\n", pid, estado);
+		if (estado!=pid*10)
+			printf("estado erroneo. NO DEBE APARECER\n");
+	}
+
+	if (esperar_proceso(obtener_id_pr(), 0)>=0)
+		printf("se espera a si mismo. NO DEBE APARECER\n");
+	if (esperar_proceso(100000, 0)>=0)
+		printf("espera a un proceso que no existe. NO DEBE APARECER\n");
+
+	pid=crear_proceso("excep_arit");
+	if ((esperar_proceso(pid, &estado)!=pid) || (estado!=-1))
+		printf("estado de excep_arit erroneo. NO DEBE APARECER\n");
+	else
+		printf("excep_arit abortado con estado %d\n", estado);
+
+	/* el hijo termina mientras el padre duerme y queda como zombi */
+	pid=crear_proceso("saliente");
+	dormir(1);
+	if ((esperar_hijo(&estado)!=pid) || (estado!=pid*10))
+		printf("zombi erroneo. NO DEBE APARECER\n");
+	else
+		printf("recogido el zombi %d sin bloquearse\n", pid);
+
+	printf("prueba_esperar termina\n");
+	return 0;
+}
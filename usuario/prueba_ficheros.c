@@ -0,0 +1,106 @@
+/*
+ * usuario/prueba_ficheros.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el sistema de ficheros en memoria y
+ * mide el rendimiento de escritura y de lectura alineada a pagina con
+ * ficheros de distintos tamanos.
+ */
+
+#include "servicios.h"
+
+#define TAM_BLOQUE 4096
+#define TOTAL (256*1024*1024)	/* bytes movidos en cada medida */
+#define TICKS_SEG 100		/* valor de TICK en el kernel */
+
+static int tamanos[]={4096, 65536, 1024*1024};
+static char buf[TAM_BLOQUE];
+
+static int mbs(int ticks) {
+	return TOTAL/(1024*1024)*TICKS_SEG/(ticks ? ticks : 1);
+}
+
+static void funcionalidad() {
+	char linea[32];
+	int fd, n;
+
+	if (crear_directorio("/etc")<0)
+		printf("error creando /etc. NO DEBE APARECER\n");
+	if (crear_directorio("/no/existe")>=0)
+		printf("se crea en directorio inexistente. NO DEBE APARECER\n");
+
+	fd=abrir("/etc/config", F_ESCRITURA|F_CREAR);
+	escribir_fichero(fd, "tick=100\n", 9);
+	posicionar(fd, 8192, DESDE_INICIO);
+	escribir_fichero(fd, "fin", 3);
+	cerrar_fichero(fd);
+
+	fd=abrir("/etc/config", F_LECTURA);
+	n=leer_fichero(fd, linea, 9);
+	linea[n]='\0';
+	printf("leido: %s", linea);
+
+	/* entre medias hay un hueco sin paginas que se lee como ceros */
+	posicionar(fd, 8000, DESDE_INICIO);
+	n=leer_fichero(fd, buf, TAM_BLOQUE);
+	printf("leidos %d bytes, hueco a cero: %d, final: %c%c%c\n", n,
+		buf[0]==0 && buf[191]==0, buf[192], buf[193], buf[194]);
+
+	if (escribir_fichero(fd, "x", 1)>=0)
+		printf("se escribe en un fichero de lectura. NO DEBE APARECER\n");
+	if (borrar("/etc")>=0)
+		printf("se borra un directorio no vacio. NO DEBE APARECER\n");
+
+	/* sigue siendo legible hasta que se cierra */
+	borrar("/etc/config");
+	posicionar(fd, 0, DESDE_INICIO);
+	if (leer_fichero(fd, linea, 4)==4)
+		printf("fichero borrado pero abierto sigue legible. DEBE APARECER\n");
+	cerrar_fichero(fd);
+
+	if (abrir("/etc/config", F_LECTURA)<0)
+		printf("el fichero ya no existe. DEBE APARECER\n");
+	borrar("/etc");
+}
+
+int main(){
+	int i, j, k, fd, t0, t1, t2;
+
+	printf("prueba_ficheros comienza\n");
+
+	funcionalidad();
+
+	crear_directorio("/tmp");
+	for (i=0; i<sizeof(tamanos)/sizeof(int); i++) {
+		fd=abrir("/tmp/datos", F_LECTURA|F_ESCRITURA|F_CREAR);
+
+		t0=tiempos_proceso(0);
+		for (k=0; k<TOTAL/tamanos[i]; k++) {
+			posicionar(fd, 0, DESDE_INICIO);
+			for (j=0; j<tamanos[i]; j+=TAM_BLOQUE)
+				escribir_fichero(fd, buf, TAM_BLOQUE);
+		}
+		t1=tiempos_proceso(0);
+		for (k=0; k<TOTAL/tamanos[i]; k++) {
+			posicionar(fd, 0, DESDE_INICIO);
+			for (j=0; j<tamanos[i]; j+=TAM_BLOQUE)
+				leer_fichero(fd, buf, TAM_BLOQUE);
+		}
+		t2=tiempos_proceso(0);
+
+		printf("fichero de %7d bytes: escritura %d MB/s, lectura %d MB/s\n",
+			tamanos[i], mbs(t1-t0), mbs(t2-t1));
+
+		cerrar_fichero(fd);
+		borrar("/tmp/datos");
+	}
+
+	printf("prueba_ficheros termina\n");
+	return 0;
+}
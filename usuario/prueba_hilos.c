@@ -0,0 +1,143 @@
+/*
+ * usuario/prueba_hilos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los hilos del kernel. Cuatro hilos suman
+ * partes de un vector global acumulando en un total protegido por un
+ * mutex que crea el hilo inicial, y uno de ellos crea otro mutex que
+ * despues usa el hilo inicial. Dos hilos tienen a la vez un cerrojo en
+ * lectura por el mismo descriptor, y ninguno puede soltar el del otro.
+ * Un hilo que termina con el cerrojo en escritura lo suelta y libera la
+ * region que habia creado.
+ * Se compara crear y esperar un hilo con
+ * crear y esperar un proceso, y al final el hilo inicial termina antes
+ * que un hilo rezagado, que debe seguir funcionando.
+ */
+
+#include "servicios.h"
+
+#define HILOS 4
+#define TAM 40000
+#define ITERACIONES 2000
+#define US_TICK 10000		/* microsegundos por tick del kernel */
+
+static int vector[TAM];
+static long total;
+static int mutex_total, mutex_hilo=-1, cerrojo, region_hilo;
+
+static int sumar(void *arg) {
+	int parte=(long)arg, i;
+	long suma=0;
+
+	for (i=parte*TAM/HILOS; i<(parte+1)*TAM/HILOS; i++)
+		suma+=vector[i];
+
+	lock(mutex_total);
+	total+=suma;
+	unlock(mutex_total);
+
+	if (parte==0)
+		mutex_hilo=crear_mutex("de_hilo", NO_RECURSIVO);
+
+	return parte+100;
+}
+
+//El hilo inicial tiene el cerrojo en lectura
+static int lector_cerrojo(void *arg) {
+	int bien=(lock_lectura(cerrojo)>=0);
+
+	if (unlock_cerrojo(cerrojo)<0)
+		bien=0;
+	if (unlock_cerrojo(cerrojo)>=0)
+		bien=0;		/* el del hilo inicial no es suyo */
+	return bien;
+}
+
+//Termina con el cerrojo y siendo propietario de una region
+static int escritor_saliente(void *arg) {
+	void *dir;
+
+	region_hilo=crear_region(4096, &dir);
+	return lock_escritura(cerrojo);
+}
+
+static int vacio(void *arg) {
+	return 0;
+}
+
+static int rezagado(void *arg) {
+	dormir(1);
+	lock(mutex_total);
+	printf("hilo rezagado: sigue funcionando sin el hilo inicial\n");
+	unlock(mutex_total);
+	return 0;
+}
+
+int main(){
+	int pids[HILOS];
+	int i, valor, bien=1, t0, t1;
+
+	printf("prueba_hilos comienza\n");
+
+	for (i=0; i<TAM; i++)
+		vector[i]=i;
+	mutex_total=crear_mutex("total", NO_RECURSIVO);
+
+	if (esperar_hilo(obtener_id_pr(), 0)>=0)
+		printf("esperar a si mismo. NO DEBE APARECER\n");
+
+	for (i=0; i<HILOS; i++)
+		pids[i]=crear_hilo(sumar, (void *)(long)i);
+	for (i=0; i<HILOS; i++)
+		if ((esperar_hilo(pids[i], &valor)<0) || (valor!=i+100))
+			bien=0;
+	if (esperar_hilo(pids[0], &valor)>=0)
+		printf("esperar dos veces al mismo hilo. NO DEBE APARECER\n");
+
+	printf("total %ld (debe ser %ld), valores de los hilos %s\n",
+		total, (long)TAM*(TAM-1)/2, bien ? "correctos" : "ERRONEOS");
+
+	/* el descriptor lo creo otro hilo pero es del proceso */
+	if ((mutex_hilo<0) || (lock(mutex_hilo)<0) || (unlock(mutex_hilo)<0))
+		printf("mutex del hilo no disponible. ERROR\n");
+	else
+		printf("mutex creado por un hilo usado por el hilo inicial\n");
+
+	cerrojo=crear_cerrojo("de_hilos", PREF_LECTORES);
+	lock_lectura(cerrojo);
+	esperar_hilo(crear_hilo(lector_cerrojo, 0), &valor);
+	printf("cerrojo en lectura por dos hilos %s\n",
+		(valor && (unlock_cerrojo(cerrojo)>=0)) ? "correcto" : "ERRONEO");
+
+	esperar_hilo(crear_hilo(escritor_saliente, 0), 0);
+	if (lock_escritura(cerrojo)<0)
+		printf("cerrojo de un hilo terminado no disponible. ERROR\n");
+	else
+		printf("cerrojo soltado al terminar el hilo que lo tenia\n");
+	unlock_cerrojo(cerrojo);
+	if (liberar_region(region_hilo)>=0)
+		printf("region de un hilo terminado sigue abierta. NO DEBE APARECER\n");
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++)
+		esperar_hilo(crear_hilo(vacio, 0), 0);
+	t1=tiempos_proceso(0);
+	printf("hilo: %d us por crear y esperar\n", (t1-t0)*US_TICK/ITERACIONES);
+
+	esperar_proceso(crear_proceso("efimero"), 0);
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++)
+		esperar_proceso(crear_proceso("efimero"), 0);
+	t1=tiempos_proceso(0);
+	printf("proceso: %d us por crear y esperar\n", (t1-t0)*US_TICK/ITERACIONES);
+
+	crear_hilo(rezagado, 0);
+	printf("prueba_hilos: termina el hilo inicial\n");
+	return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * usuario/prueba_hilos_usuario.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los hilos de usuario. Compara el coste
+ * de un cambio entre dos hilos de usuario que ceden la UCP con el de un
+ * cambio entre dos hilos del kernel que la ceden con ceder_procesador
+ * (expulsion por int_sw). Despues varios hilos de usuario sobre cuatro
+ * portadores incrementan un contador con un mutex de usuario y se pasan
+ * datos por un buffer con condiciones, y se comprueba que hu_dormir solo
+ * para al hilo que la llama, mientras que dormir para a su portador.
+ */
+
+#include "servicios.h"
+
+#define CESIONES_HU 1000000
+#define CESIONES_KERNEL 20000
+#define US_TICK 10000		/* microsegundos por tick del kernel */
+
+#define SUMADORES 16
+#define INCREMENTOS 2000
+#define PORTADORES 4
+
+#define TAM_BUFFER 4
+#define DATOS 5000
+
+static int n_cesiones;
+
+static void cedente_hu(void *arg) {
+	int i;
+
+	for (i=0; i<n_cesiones; i++)
+		hu_ceder();
+}
+
+static int cedente_kernel(void *arg) {
+	int i;
+
+	for (i=0; i<n_cesiones; i++)
+		ceder_procesador();
+	return 0;
+}
+
+//Nanosegundos por cambio en ticks ticks con n cambios
+static long ns_cambio(int ticks, int n) {
+	return (long)ticks*US_TICK*1000/n;
+}
+
+/* Contador compartido */
+static hu_mutex mutex;
+static long contador;
+
+static void sumador(void *arg) {
+	int i;
+	long c;
+
+	for (i=0; i<INCREMENTOS; i++) {
+		hu_mutex_lock(&mutex);
+		c=contador;
+		if (i%64==0)
+			hu_ceder();	/* otro hilo intenta entrar mientras */
+		contador=c+1;
+		hu_mutex_unlock(&mutex);
+	}
+}
+
+/* Buffer acotado */
+static hu_mutex mutex_buf;
+static hu_cond hay_hueco, hay_dato;
+static int buffer[TAM_BUFFER], n_buf, ent, sal;
+static long suma_consumida;
+
+static void productor(void *arg) {
+	int i;
+
+	for (i=1; i<=DATOS; i++) {
+		hu_mutex_lock(&mutex_buf);
+		while (n_buf==TAM_BUFFER)
+			hu_cond_esperar(&hay_hueco, &mutex_buf);
+		buffer[ent]=i;
+		ent=(ent+1)%TAM_BUFFER;
+		n_buf++;
+		hu_cond_senalar(&hay_dato);
+		hu_mutex_unlock(&mutex_buf);
+	}
+}
+
+static void consumidor(void *arg) {
+	int i;
+
+	for (i=0; i<DATOS; i++) {
+		hu_mutex_lock(&mutex_buf);
+		while (n_buf==0)
+			hu_cond_esperar(&hay_dato, &mutex_buf);
+		suma_consumida+=buffer[sal];
+		sal=(sal+1)%TAM_BUFFER;
+		n_buf--;
+		hu_cond_senalar(&hay_hueco);
+		hu_mutex_unlock(&mutex_buf);
+	}
+}
+
+/* Espera de un hilo mientras otro avanza */
+static volatile int fin_espera;
+static volatile long avances;
+static long avance_hu, avance_kernel;
+
+static void dormilon_hu(void *arg) {
+	long antes;
+
+	antes=avances;
+	hu_dormir(300);
+	avance_hu=avances-antes;
+
+	antes=avances;
+	dormir(1);
+	avance_kernel=avances-antes;
+
+	fin_espera=1;
+}
+
+static void contador_avances(void *arg) {
+	while (!fin_espera) {
+		avances++;
+		hu_ceder();
+	}
+}
+
+int main(){
+	int pids[2];
+	int i, t0, t1, ticks_hu, ticks_kernel;
+
+	printf("prueba_hilos_usuario comienza\n");
+
+	/* coste del cambio de contexto */
+	n_cesiones=CESIONES_HU;
+	hu_crear(cedente_hu, 0);
+	hu_crear(cedente_hu, 0);
+	t0=tiempos_proceso(0);
+	hu_ejecutar(1);
+	t1=tiempos_proceso(0);
+	ticks_hu=t1-t0;
+
+	n_cesiones=CESIONES_KERNEL;
+	t0=tiempos_proceso(0);
+	pids[0]=crear_hilo(cedente_kernel, 0);
+	pids[1]=crear_hilo(cedente_kernel, 0);
+	esperar_hilo(pids[0], 0);
+	esperar_hilo(pids[1], 0);
+	t1=tiempos_proceso(0);
+	ticks_kernel=t1-t0;
+
+	printf("hilos de usuario: %d cambios en %d ticks, %ld ns por cambio\n",
+		2*CESIONES_HU, ticks_hu, ns_cambio(ticks_hu, 2*CESIONES_HU));
+	printf("hilos del kernel: %d cambios en %d ticks, %ld ns por cambio\n",
+		2*CESIONES_KERNEL, ticks_kernel, ns_cambio(ticks_kernel, 2*CESIONES_KERNEL));
+
+	/* mutex de usuario sobre varios portadores */
+	hu_mutex_iniciar(&mutex);
+	for (i=0; i<SUMADORES; i++)
+		if (hu_crear(sumador, 0)<0)
+			printf("error creando sumador %d\n", i);
+	hu_ejecutar(PORTADORES);
+	printf("contador %ld (debe ser %d)\n", contador, SUMADORES*INCREMENTOS);
+
+	/* condiciones de usuario */
+	hu_mutex_iniciar(&mutex_buf);
+	hu_cond_iniciar(&hay_hueco);
+	hu_cond_iniciar(&hay_dato);
+	hu_crear(productor, 0);
+	hu_crear(consumidor, 0);
+	hu_crear(productor, 0);
+	hu_crear(consumidor, 0);
+	hu_ejecutar(PORTADORES);
+	printf("suma consumida %ld (debe ser %ld)\n", suma_consumida,
+		2L*DATOS*(DATOS+1)/2);
+
+	/* con un portador: hu_dormir deja avanzar al otro hilo y dormir no */
+	hu_crear(dormilon_hu, 0);
+	hu_crear(contador_avances, 0);
+	hu_ejecutar(1);
+	printf("avances del otro hilo con hu_dormir %ld (mas de 0), con dormir %ld (0)\n",
+		avance_hu, avance_kernel);
+
+	if (hu_mutex_lock(&mutex)>=0)
+		printf("hu_mutex_lock fuera de un hilo de usuario. NO DEBE APARECER\n");
+
+	printf("prueba_hilos_usuario termina\n");
+	return 0;
+}
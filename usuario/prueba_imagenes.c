@@ -0,0 +1,53 @@
+/*
+ * usuario/prueba_imagenes.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la latencia de crear un proceso con la
+ * cache de imagenes desactivada (cada proceso carga su programa) y con
+ * ella activada (el programa ya esta cargado). Cada proceso creado
+ * termina antes de crear el siguiente, de modo que sin cache su imagen se
+ * descarga entre uno y otro.
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 2000
+#define US_TICK 10000	/* microsegundos por tick del kernel */
+
+static void medir(char *nombre) {
+	struct estad_imagenes e;
+	int i, t0, t1;
+
+	estadisticas_imagenes(0);
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++)
+		if (esperar_proceso(crear_proceso("efimero"), 0)<0)
+			printf("Error creando efimero\n");
+	t1=tiempos_proceso(0);
+	estadisticas_imagenes(&e);
+
+	printf("%s: %d us por crear y esperar un proceso (aciertos %d, fallos %d)\n",
+		nombre, (t1-t0)*US_TICK/ITERACIONES, e.aciertos, e.fallos);
+}
+
+int main(){
+	printf("prueba_imagenes comienza\n");
+
+	if (ajustar_cache_imagenes(-1)>=0)
+		printf("tamano de cache negativo. NO DEBE APARECER\n");
+
+	ajustar_cache_imagenes(0);
+	medir("cache fria");
+
+	ajustar_cache_imagenes(8);
+	medir("cache caliente");
+
+	printf("prueba_imagenes termina\n");
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * usuario/prueba_lect_esc.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que compara un cerrojo de lectores/escritores con
+ * un mutex en una carga con muchas mas lecturas que escrituras. Varios
+ * procesos lector_rw leen el objeto "rw" mientras este proceso escribe
+ * una vez. Todos duermen dentro de la seccion critica simulando una
+ * operacion de E/S.
+ */
+
+#include "servicios.h"
+
+#define NUM_LECTORES 4
+#define ESPERA_FASE 10	/* segundos que dura cada fase */
+
+static void fase(char *titulo, int desc, int cerrojo) {
+	int i, t0, t1;
+
+	t0=tiempos_proceso(0);
+	printf("prueba_lect_esc: %s comienza en tick %d\n", titulo, t0);
+
+	for (i=0; i<NUM_LECTORES; i++)
+		if (crear_proceso("lector_rw")<0)
+			printf("Error creando lector_rw\n");
+
+	/* deja empezar a los lectores y luego intenta escribir */
+	dormir(1);
+	if (cerrojo) lock_escritura(desc); else lock(desc);
+	t1=tiempos_proceso(0);
+	printf("prueba_lect_esc: escribe en tick %d\n", t1);
+	dormir(1);
+	if (cerrojo) unlock_cerrojo(desc); else unlock(desc);
+
+	dormir(ESPERA_FASE);
+}
+
+int main(){
+	int desc;
+
+	printf("prueba_lect_esc: comienza\n");
+
+	desc=crear_mutex("rw", NO_RECURSIVO);
+	fase("mutex", desc, 0);
+	cerrar_mutex(desc);
+
+	desc=crear_cerrojo("rw", PREF_LECTORES);
+	fase("cerrojo con preferencia de lectores", desc, 1);
+	cerrar_cerrojo(desc);
+
+	desc=crear_cerrojo("rw", PREF_ESCRITORES);
+	fase("cerrojo con preferencia de escritores", desc, 1);
+	cerrar_cerrojo(desc);
+
+	printf("prueba_lect_esc: termina\n");
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * usuario/prueba_mensajes.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la latencia de ida y vuelta del paso de
+ * mensajes sincrono contra el proceso servidor_eco, y la compara con la
+ * de hacer lo mismo con un par de tuberias.
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 10000
+#define US_TICK 10000	/* microsegundos por tick del kernel */
+
+static void resultado(char *nombre, int t0, int t1) {
+	if (t1==t0)
+		t1++;
+	printf("%s: %d ticks, %d us por ida y vuelta\n", nombre, t1-t0,
+		(t1-t0)*US_TICK/ITERACIONES);
+}
+
+int main(){
+	char msg[TAM_MENSAJE];
+	int pedidos[2], respuestas[2];
+	int i, pid, t0, t1;
+
+	printf("prueba_mensajes comienza\n");
+
+	/* el servidor las hereda en los descriptores 0 a 3 */
+	crear_tuberia(pedidos);
+	crear_tuberia(respuestas);
+
+	if (crear_proceso("servidor_eco")<0)
+		printf("Error creando servidor_eco\n");
+	cerrar_tuberia(pedidos[0]);
+	cerrar_tuberia(respuestas[1]);
+
+	/* crear_proceso no devuelve el pid: lo manda el servidor */
+	leer_tuberia(respuestas[0], &pid, sizeof(pid));
+
+	if (llamar(obtener_id_pr(), msg, 8)>=0)
+		printf("se llama a si mismo. NO DEBE APARECER\n");
+	if (responder(pid, msg, 8)>=0)
+		printf("responde sin llamada. NO DEBE APARECER\n");
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++) {
+		msg[0]=i%128;
+		if ((llamar(pid, msg, 8)!=8) || (msg[0]!=i%128))
+			printf("respuesta erronea. NO DEBE APARECER\n");
+	}
+	t1=tiempos_proceso(0);
+	resultado("llamar", t0, t1);
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++) {
+		escribir_tuberia(pedidos[1], msg, 8);
+		leer_tuberia(respuestas[0], msg, 8);
+	}
+	t1=tiempos_proceso(0);
+	resultado("tuberias", t0, t1);
+
+	printf("prueba_mensajes termina\n");
+	return 0;
+}
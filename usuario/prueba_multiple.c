@@ -0,0 +1,74 @@
+/*
+ * usuario/prueba_multiple.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de esperar_multiple. Espera
+ * sobre un semaforo y un mutex que maneja el proceso avisador y termina
+ * esperando caracteres del terminal con un plazo de medio segundo.
+ */
+
+#include "servicios.h"
+
+int main(){
+	struct evento ev[MAX_EVENTOS+1];
+	int mm, sm, res;
+
+	printf("prueba_multiple comienza\n");
+
+	if ((mm=crear_mutex("mm", NO_RECURSIVO))<0)
+		printf("error creando mm. NO DEBE APARECER\n");
+	if ((sm=crear_sem("sm", 0))<0)
+		printf("error creando sm. NO DEBE APARECER\n");
+
+	ev[0].tipo=EVENTO_SEM;
+	ev[0].desc=sm;
+
+	if (esperar_multiple(ev, MAX_EVENTOS+1, -1)!=-1)
+		printf("se aceptan demasiados eventos. NO DEBE APARECER\n");
+	if (esperar_multiple(ev, 0, -1)!=-1)
+		printf("se acepta esperar sin eventos ni plazo. NO DEBE APARECER\n");
+
+	/* consulta sin bloquear: todavia nadie ha senalado sm */
+	if (esperar_multiple(ev, 1, 0)==ESPERA_TIMEOUT)
+		printf("sm sin senalar. DEBE APARECER\n");
+
+	if (crear_proceso("avisador")<0)
+		printf("Error creando avisador\n");
+
+	res=esperar_multiple(ev, 1, -1);
+	printf("prueba_multiple: evento %d listo en tick %d (DEBE SER 0)\n",
+		res, tiempos_proceso(0));
+	esperar_sem(sm);
+
+	/* mm lo tiene avisador hasta un segundo despues; sm ya esta a 0 */
+	ev[0].tipo=EVENTO_MUTEX;
+	ev[0].desc=mm;
+	ev[1].tipo=EVENTO_SEM;
+	ev[1].desc=sm;
+	res=esperar_multiple(ev, 2, -1);
+	printf("prueba_multiple: evento %d listo en tick %d (DEBE SER 0)\n",
+		res, tiempos_proceso(0));
+	lock(mm);
+	unlock(mm);
+
+	ev[1].desc=99;
+	if (esperar_multiple(ev, 2, -1)!=-1)
+		printf("se acepta un descriptor erroneo. NO DEBE APARECER\n");
+
+	ev[0].tipo=EVENTO_TERMINAL;
+	res=esperar_multiple(ev, 1, 500);
+	if (res==ESPERA_TIMEOUT)
+		printf("prueba_multiple: vence el plazo en tick %d (si no se pulsa nada)\n",
+			tiempos_proceso(0));
+	else
+		printf("prueba_multiple: se ha pulsado %c\n", leer_caracter());
+
+	printf("prueba_multiple termina\n");
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * usuario/prueba_pilas.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide la creacion y terminacion de procesos con
+ * la reserva de pilas desactivada (cada proceso pide su pila y la libera)
+ * y activada (las pilas se reutilizan). Se crean los procesos de GRUPO en
+ * GRUPO, esperando a que termine cada grupo antes de crear el siguiente,
+ * y se muestran los procesos por segundo y los fallos de pagina.
+ */
+
+#include "servicios.h"
+
+#define GRUPOS 20
+#define GRUPO 100
+#define US_TICK 10000	/* microsegundos por tick del kernel */
+
+static void medir(char *nombre) {
+	struct estad_pilas e;
+	int i, j, t0, t1;
+
+	estadisticas_pilas(0);
+	t0=tiempos_proceso(0);
+	for (i=0; i<GRUPOS; i++) {
+		for (j=0; j<GRUPO; j++)
+			if (crear_proceso("efimero")<0)
+				printf("Error creando efimero\n");
+		for (j=0; j<GRUPO; j++)
+			esperar_hijo(0);
+	}
+	t1=tiempos_proceso(0);
+	estadisticas_pilas(&e);
+
+	if (t1==t0)
+		t1++;
+	printf("%s: %d procesos/s, %d fallos de pagina (reutilizadas %d, creadas %d, liberadas %d)\n",
+		nombre, GRUPOS*GRUPO*(1000000/US_TICK)/(t1-t0), e.fallos_pagina,
+		e.reutilizadas, e.creadas, e.liberadas);
+}
+
+static int pilas_libres() {
+	struct estad_pilas e;
+
+	estadisticas_pilas(&e);
+	return e.libres;
+}
+
+int main(){
+	printf("prueba_pilas comienza\n");
+
+	if (ajustar_pilas(-1)>=0)
+		printf("tamano de reserva negativo. NO DEBE APARECER\n");
+
+	/* el programa queda en la cache de imagenes en ambas medidas */
+	esperar_proceso(crear_proceso("efimero"), 0);
+
+	ajustar_pilas(0);
+	medir("sin reserva");
+
+	/* guarda las pilas de un grupo entero aunque solo conserve 16 */
+	ajustar_pilas(16);
+	medir("con reserva");
+
+	/* sin crear procesos la reserva se recorta a 16 */
+	printf("antes del recorte hay %d pilas en la reserva\n", pilas_libres());
+	dormir(2);
+	printf("tras el recorte quedan %d pilas en la reserva\n", pilas_libres());
+
+	printf("prueba_pilas termina\n");
+	return 0;
+}
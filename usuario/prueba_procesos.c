@@ -0,0 +1,66 @@
+/*
+ * usuario/prueba_procesos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide lo que cuesta crear y terminar un proceso
+ * con 10, 100 y 1000 procesos vivos. Los procesos de fondo son instancias
+ * de inactivo bloqueadas en una tuberia; los que se crean y terminan son
+ * instancias de efimero, en tandas cuyo final se detecta con el fin de
+ * fichero de otra tuberia.
+ */
+
+#include "servicios.h"
+
+#define TANDA 10		/* procesos creados antes de esperar a que acaben */
+#define TANDAS 200
+#define US_TICK 10000		/* microsegundos por tick del kernel */
+
+static int niveles[]={10, 100, 1000};
+
+int main(){
+	int fondo[2], tanda[2];
+	int i, j, k, vivos, t0, t1;
+	char c;
+
+	printf("prueba_procesos comienza\n");
+
+	/* los inactivos leen de la tuberia hasta el final: fondo[0] y
+	   fondo[1] son los descriptores 0 y 1 que heredan */
+	crear_tuberia(fondo);
+
+	vivos=1;
+	for (i=0; i<sizeof(niveles)/sizeof(int); i++) {
+		for (; vivos<niveles[i]; vivos++)
+			if (crear_proceso("inactivo")<0)
+				printf("Error creando inactivo\n");
+
+		t0=tiempos_proceso(0);
+		for (j=0; j<TANDAS; j++) {
+			crear_tuberia(tanda);
+			for (k=0; k<TANDA; k++)
+				if (crear_proceso("efimero")<0)
+					printf("Error creando efimero\n");
+			cerrar_tuberia(tanda[1]);
+
+			/* fin de fichero cuando han terminado todos */
+			while (leer_tuberia(tanda[0], &c, 1)>0);
+			cerrar_tuberia(tanda[0]);
+		}
+		t1=tiempos_proceso(0);
+
+		printf("%4d procesos vivos: %d us por crear y terminar un proceso\n",
+			vivos, (t1-t0)*US_TICK/(TANDA*TANDAS));
+	}
+
+	cerrar_tuberia(fondo[1]);
+	cerrar_tuberia(fondo[0]);
+
+	printf("prueba_procesos termina\n");
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * usuario/prueba_reclamo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el reclamo de las pilas de los procesos
+ * bloqueados mucho tiempo. Crea 100 instancias de hondo, que usan 24 KB
+ * de pila y duermen 3 segundos, y muestra la memoria residente antes y
+ * despues de que se reclamen sus pilas, lo reclamado y lo que cuesta
+ * restaurarlas al despertar. Se repite con el reclamo desactivado.
+ */
+
+#include "servicios.h"
+
+#define PROCESOS 100
+
+static int residente() {
+	struct estad_pilas e;
+
+	estadisticas_pilas(&e);
+	return e.residente_kb;
+}
+
+static void medir(char *nombre, int ticks) {
+	struct estad_reclamo e;
+	int i, estado, mal=0, dormidos, reclamados;
+
+	ajustar_reclamo(ticks);
+	estadisticas_reclamo(0);
+
+	for (i=0; i<PROCESOS; i++)
+		if (crear_proceso("hondo")<0)
+			printf("Error creando hondo\n");
+
+	/* todos dormidos y, con reclamo, pasado el umbral */
+	dormir(1);
+	dormidos=residente();
+	dormir(1);
+	reclamados=residente();
+
+	for (i=0; i<PROCESOS; i++)
+		if ((esperar_hijo(&estado)<0) || (estado!=1))
+			mal++;
+	estadisticas_reclamo(&e);
+
+	printf("%s: residente %d KB dormidos, %d KB tras el umbral\n",
+		nombre, dormidos, reclamados);
+	printf("%s: %d pilas reclamadas, %d KB, %d restauradas (%d us cada una)%s\n",
+		nombre, e.procesos, e.bytes_reclamados/1024, e.restauraciones,
+		e.restauraciones ? e.us_restauracion/e.restauraciones : 0,
+		mal ? " ERROR EN LOS DATOS" : "");
+}
+
+int main(){
+	printf("prueba_reclamo comienza\n");
+
+	if (ajustar_reclamo(-1)>=0)
+		printf("umbral negativo. NO DEBE APARECER\n");
+
+	medir("sin reclamo", 0);
+	medir("con reclamo", 150);
+
+	ajustar_reclamo(500);
+	printf("prueba_reclamo termina\n");
+	return 0;
+}
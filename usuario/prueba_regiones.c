@@ -0,0 +1,96 @@
+/*
+ * usuario/prueba_regiones.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las regiones transferibles: pasa una
+ * region llena de datos al proceso receptor, que la comprueba y la
+ * devuelve, y compara el tiempo de ida y vuelta con el de mandar los
+ * mismos datos por un par de tuberias.
+ */
+
+#include "servicios.h"
+
+#define TAM_REGION (64*1024)
+#define ITERACIONES 2000
+#define US_TICK 10000	/* microsegundos por tick del kernel */
+
+static void resultado(char *nombre, int t0, int t1) {
+	if (t1==t0)
+		t1++;
+	printf("%s: %d ticks, %d us por ida y vuelta de %d KB, %d MB/s\n",
+		nombre, t1-t0, (t1-t0)*US_TICK/ITERACIONES, TAM_REGION/1024,
+		2*ITERACIONES/(t1-t0)*(TAM_REGION/1024)*100/1024);
+}
+
+/* las tuberias pueden devolver menos de lo pedido */
+static void leer_todo(int fd, void *buf, int tam) {
+	int n;
+
+	for (n=0; n<tam; n+=leer_tuberia(fd, (char *)buf+n, tam-n));
+}
+
+int main(){
+	int pedidos[2], respuestas[2];
+	int i, j, des, pid, origen, tam, t0, t1;
+	int *datos;
+	void *dir;
+
+	printf("prueba_regiones comienza\n");
+
+	/* el receptor las hereda en los descriptores 0 a 3 */
+	crear_tuberia(pedidos);
+	crear_tuberia(respuestas);
+
+	if (crear_proceso("receptor")<0)
+		printf("Error creando receptor\n");
+	cerrar_tuberia(pedidos[0]);
+	cerrar_tuberia(respuestas[1]);
+	leer_tuberia(respuestas[0], &pid, sizeof(pid));
+
+	des=crear_region(TAM_REGION, &dir);
+	if (((long)dir)%4096!=0)
+		printf("region no alineada a pagina. NO DEBE APARECER\n");
+	datos=dir;
+	for (j=0; j<TAM_REGION/sizeof(int); j++)
+		datos[j]=j;
+
+	if (transferir_region(des, obtener_id_pr())>=0)
+		printf("se transfiere a si mismo. NO DEBE APARECER\n");
+
+	/* el receptor suma los datos y devuelve la region con la suma al
+	   principio: los datos no se copian en ningun momento */
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++) {
+		datos[1]=i;
+		transferir_region(des, pid);
+		des=recibir_region(&dir, &tam, &origen);
+		datos=dir;
+		if ((datos[0]!=i) || (origen!=pid) || (tam!=TAM_REGION))
+			printf("region devuelta erronea. NO DEBE APARECER\n");
+	}
+	t1=tiempos_proceso(0);
+	resultado("regiones", t0, t1);
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<ITERACIONES; i++) {
+		escribir_tuberia(pedidos[1], datos, TAM_REGION);
+		leer_todo(respuestas[0], datos, TAM_REGION);
+	}
+	t1=tiempos_proceso(0);
+	resultado("tuberias", t0, t1);
+
+	/* la ultima region se la queda el receptor: despues de transferirla
+	   ya no se puede acceder a ella */
+	transferir_region(des, pid);
+
+	printf("prueba_regiones termina accediendo a la region transferida\n");
+	datos[0]=0;
+	printf("se accede a una region transferida. NO DEBE APARECER\n");
+	return 0;
+}
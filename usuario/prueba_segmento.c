@@ -0,0 +1,54 @@
+/*
+ * usuario/prueba_segmento.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la memoria compartida:
+ * rellena el segmento "datos" y el proceso sumador deja en el la suma
+ * sin que se copie nada a traves de llamadas al sistema.
+ */
+
+#include "servicios.h"
+
+#define NUM_ENTEROS (256*1024)
+
+int main(){
+	int *datos, *otra;
+	int seg, sem, i;
+
+	printf("prueba_segmento comienza\n");
+
+	if (crear_segmento("datos", 0, (void **)&datos)>=0)
+		printf("se crea un segmento vacio. NO DEBE APARECER\n");
+
+	/* un entero mas para el resultado */
+	if ((seg=crear_segmento("datos", (NUM_ENTEROS+1)*sizeof(int), (void **)&datos))<0)
+		printf("error creando datos. NO DEBE APARECER\n");
+	if ((sem=crear_sem("hecho", 0))<0)
+		printf("error creando hecho. NO DEBE APARECER\n");
+
+	for (i=0; i<NUM_ENTEROS; i++)
+		datos[i]=i%100;
+
+	if (crear_proceso("sumador")<0)
+		printf("Error creando sumador\n");
+	esperar_sem(sem);
+
+	printf("prueba_segmento: suma %d en %p (DEBE SER %d)\n", datos[NUM_ENTEROS],
+		datos, NUM_ENTEROS/100*4950+(NUM_ENTEROS%100)*(NUM_ENTEROS%100-1)/2);
+
+	desasociar_segmento(seg);
+	if (asociar_segmento("datos", (void **)&otra, 0)<0)
+		printf("el segmento ya no existe. DEBE APARECER\n");
+
+	/* el que no se desasocia se libera al terminar */
+	crear_segmento("resto", 4096, (void **)&otra);
+
+	printf("prueba_segmento termina\n");
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * usuario/prueba_sem.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los semaforos: hace de
+ * productor de un buffer de 2 huecos cuyo consumidor es el proceso
+ * consumidor.
+ */
+
+#include "servicios.h"
+
+#define TOT_ELEM 5
+
+int main(){
+	int huecos, elems, i;
+
+	printf("prueba_sem comienza\n");
+
+	if ((huecos=crear_sem("huecos", 2))<0)
+		printf("error creando huecos. NO DEBE APARECER\n");
+
+	if ((elems=crear_sem("elems", 0))<0)
+		printf("error creando elems. NO DEBE APARECER\n");
+
+	if (crear_sem("huecos", 1)<0)
+		printf("error creando huecos por segunda vez. DEBE APARECER\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	/* tras los 2 primeros se bloquea hasta que consuma el consumidor */
+	for (i=1; i<=TOT_ELEM; i++) {
+		esperar_sem(huecos);
+		printf("prueba_sem produce %d\n", i);
+		senalar_sem(elems);
+	}
+
+	printf("prueba_sem termina\n");
+
+	/* cierre implicito de semaforos */
+	return 0;
+}
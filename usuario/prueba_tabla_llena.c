@@ -0,0 +1,119 @@
+/*
+ * usuario/prueba_tabla_llena.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba crear_proceso_esperando. Primero llena
+ * la tabla de procesos con instancias de inactivo y comprueba el plazo de
+ * espera. Dos hilos esperan una entrada, el primero para un programa que
+ * no existe y sin terminar despues: al terminar un proceso dormilon el
+ * segundo debe crear el suyo sin esperar a que termine otro proceso ni a
+ * que venza su plazo.
+ * Despues crea una avalancha de procesos efimero reintentando
+ * cada segundo cuando la tabla esta llena, como se hacia antes, y
+ * esperando a que se libere una entrada, y compara lo que tardan.
+ */
+
+#include "servicios.h"
+
+#define AVALANCHA 20000
+#define PLAZO_HILOS 5000	/* ms; dormilon termina mucho antes */
+#define US_TICK 10000		/* microsegundos por tick del kernel */
+
+static int sem_espera;
+static char *programas[]={"no_existe", "efimero"};
+static int espera_hilo[2];	/* ms que ha esperado cada uno */
+
+//Espera a que la tabla este llena para pedir una entrada. El que falla
+//no termina hasta el final, para que su entrada no la libere
+static int esperante(void *arg) {
+	int i=(long)arg, pid, t0;
+
+	esperar_sem(sem_espera);
+	t0=tiempos_proceso(0);
+	pid=crear_proceso_esperando(programas[i], PLAZO_HILOS);
+	espera_hilo[i]=(tiempos_proceso(0)-t0)*US_TICK/1000;
+	if (i==0)
+		esperar_sem(sem_espera);
+	return pid;
+}
+
+static void avalancha(char *nombre, int esperando) {
+	int i, pid, reintentos=0, t0, t1;
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<AVALANCHA; i++) {
+		if (esperando)
+			pid=crear_proceso_esperando("efimero", -1);
+		else
+			while ((pid=crear_proceso("efimero"))<0) {
+				reintentos++;
+				dormir(1);
+			}
+		if (pid<0)
+			printf("Error creando efimero\n");
+	}
+	t1=tiempos_proceso(0);
+
+	while (esperar_hijo(0)>=0);
+
+	printf("%s: %d procesos en %d ms (%d reintentos)\n",
+		nombre, AVALANCHA, (t1-t0)*US_TICK/1000, reintentos);
+}
+
+int main(){
+	int fondo[2];
+	int n, pid, t0, t1, erroneo, correcto, p_erroneo, p_correcto;
+
+	printf("prueba_tabla_llena comienza\n");
+
+	/* los inactivos leen de la tuberia hasta el final: fondo[0] y
+	   fondo[1] son los descriptores 0 y 1 que heredan */
+	crear_tuberia(fondo);
+
+	/* dormilon libera su entrada en dos segundos */
+	sem_espera=crear_sem("tabla", 0);
+	erroneo=crear_hilo(esperante, (void *)0L);
+	correcto=crear_hilo(esperante, (void *)1L);
+	crear_proceso("dormilon");
+
+	for (n=1; crear_proceso("inactivo")>=0; n++);
+	printf("tabla llena con %d procesos\n", n);
+
+	if (crear_proceso_esperando("efimero", 0)>=0)
+		printf("tabla llena sin esperar. NO DEBE APARECER\n");
+
+	t0=tiempos_proceso(0);
+	pid=crear_proceso_esperando("efimero", 300);
+	t1=tiempos_proceso(0);
+	printf("plazo de 300 ms: devuelve %d tras %d ms (debe ser -1)\n",
+		pid, (t1-t0)*US_TICK/1000);
+
+	senalar_sem(sem_espera);
+	senalar_sem(sem_espera);
+	esperar_hilo(correcto, &p_correcto);
+	senalar_sem(sem_espera);
+	esperar_hilo(erroneo, &p_erroneo);
+	printf("entrada de dormilon: %s (%d ms)\n",
+		((p_erroneo<0) && (p_correcto>=0) && (espera_hilo[1]<PLAZO_HILOS)) ?
+		"pasa al segundo hilo tras fallar el primero" : "perdida. ERROR",
+		espera_hilo[1]);
+
+	/* los inactivos terminan al cerrar la tuberia */
+	cerrar_tuberia(fondo[1]);
+	cerrar_tuberia(fondo[0]);
+	pid=crear_proceso_esperando("efimero", -1);
+	printf("sin plazo: crea el proceso %d al terminar un inactivo\n", pid);
+	while (esperar_hijo(0)>=0);
+
+	avalancha("reintentando", 0);
+	avalancha("esperando", 1);
+
+	printf("prueba_tabla_llena termina\n");
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * usuario/prueba_tam_pila.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las pilas que solo ocupan memoria a
+ * medida que se usan. Mide la memoria residente que anaden 200 procesos
+ * inactivos con la pila por defecto y con pilas de 1 MB, y comprueba que
+ * un proceso que necesita mucha pila muere en la pagina de guarda con la
+ * pila por defecto y termina bien si se le da una mayor.
+ */
+
+#include "servicios.h"
+
+#define PROCESOS 200
+
+static int residente() {
+	struct estad_pilas e;
+
+	estadisticas_pilas(&e);
+	return e.residente_kb;
+}
+
+static void medir(char *nombre, int tam_pila) {
+	int fondo[2];
+	int i, antes, despues;
+
+	/* los inactivos leen de la tuberia hasta el final: fondo[0] y
+	   fondo[1] son los descriptores 0 y 1 que heredan */
+	crear_tuberia(fondo);
+
+	antes=residente();
+	for (i=0; i<PROCESOS; i++)
+		if (crear_proceso_con_pila("inactivo", tam_pila)<0)
+			printf("Error creando inactivo\n");
+	dormir(1);
+	despues=residente();
+
+	printf("%s: %d KB residentes mas con %d procesos (%d KB por proceso)\n",
+		nombre, despues-antes, PROCESOS, (despues-antes)/PROCESOS);
+
+	cerrar_tuberia(fondo[1]);
+	cerrar_tuberia(fondo[0]);
+	for (i=0; i<PROCESOS; i++)
+		esperar_hijo(0);
+}
+
+int main(){
+	int estado;
+
+	printf("prueba_tam_pila comienza\n");
+
+	if (crear_proceso_con_pila("inactivo", 1024)>=0)
+		printf("pila demasiado pequena. NO DEBE APARECER\n");
+	if (crear_proceso_con_pila("inactivo", 64*1024*1024)>=0)
+		printf("pila demasiado grande. NO DEBE APARECER\n");
+
+	/* sin reserva, para que las pilas sean siempre nuevas */
+	ajustar_pilas(0);
+	medir("pila por defecto", 0);
+	medir("pila de 1 MB", 1024*1024);
+	ajustar_pilas(16);
+
+	esperar_proceso(crear_proceso("profundo"), &estado);
+	printf("profundo con la pila por defecto: estado %d (debe ser -1)\n", estado);
+
+	esperar_proceso(crear_proceso_con_pila("profundo", 256*1024), &estado);
+	printf("profundo con 256 KB de pila: estado %d (debe ser 1)\n", estado);
+
+	printf("prueba_tam_pila termina\n");
+	return 0;
+}
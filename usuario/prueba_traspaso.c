@@ -0,0 +1,66 @@
+/*
+ * usuario/prueba_traspaso.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el rendimiento y la equidad de los mutex
+ * con y sin cesion directa (TRASPASO) con 2, 4 y 8 procesos compitiendo.
+ * Cada contendiente imprime el tick en que empieza y termina: con
+ * TRASPASO todos deben terminar casi a la vez. Al final de cada fase
+ * se muestran las estadisticas de contencion del mutex.
+ */
+
+#include "servicios.h"
+
+#define ESPERA_FASE 4	/* segundos que dura cada fase */
+
+static void fase(int n, int tipo) {
+	int i, desc, t0;
+	struct estad_mutex est;
+
+	if ((desc=crear_mutex("banco", tipo))<0) {
+		printf("error creando banco. NO DEBE APARECER\n");
+		return;
+	}
+
+	/* los contendientes esperan en el mutex hasta que empiece la fase */
+	lock(desc);
+	for (i=0; i<n; i++)
+		if (crear_proceso("contendiente")<0)
+			printf("Error creando contendiente\n");
+	dormir(1);
+
+	t0=tiempos_proceso(0);
+	printf("prueba_traspaso: %d procesos %s: comienza en tick %d\n",
+		n, (tipo & TRASPASO) ? "con TRASPASO" : "sin TRASPASO", t0);
+	unlock(desc);
+
+	dormir(ESPERA_FASE);
+
+	if (estadisticas_mutex(desc, &est)<0)
+		printf("error leyendo estadisticas. NO DEBE APARECER\n");
+	printf("prueba_traspaso: %u adquisiciones (%u con espera), espera %u ticks (max %u), retencion %u ticks (max %u), cola max %u\n",
+		est.adquisiciones, est.adquisiciones_con_espera,
+		est.ticks_espera, est.max_ticks_espera,
+		est.ticks_retencion, est.max_ticks_retencion, est.max_esperando);
+	cerrar_mutex(desc);
+}
+
+int main(){
+	int n;
+
+	printf("prueba_traspaso: comienza\n");
+
+	for (n=2; n<=8; n*=2) {
+		fase(n, NO_RECURSIVO);
+		fase(n, NO_RECURSIVO|TRASPASO);
+	}
+
+	printf("prueba_traspaso: termina\n");
+	return 0;
+}
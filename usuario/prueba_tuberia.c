@@ -0,0 +1,63 @@
+/*
+ * usuario/prueba_tuberia.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que mide el rendimiento de las tuberias: el proceso
+ * productor, que hereda la tuberia, envia TOTAL bytes con varios tamanos
+ * de mensaje y este proceso los lee con el mismo tamano. Se muestran los
+ * MB/s de cada tamano y se comprueba el fin de fichero.
+ */
+
+#include "servicios.h"
+
+#define TOTAL (4*1024*1024)
+#define TICKS_SEG 100	/* valor de TICK en el kernel */
+
+static int tamanos[]={16, 256, 4096, 16384};
+static char buf[16384];
+
+int main(){
+	int descs[2];
+	int i, leidos, n, t0, t1;
+
+	printf("prueba_tuberia comienza\n");
+
+	/* la tuberia debe quedar en los descriptores 0 y 1 */
+	if (crear_tuberia(descs)<0)
+		printf("error creando tuberia. NO DEBE APARECER\n");
+	if (leer_tuberia(descs[1], buf, 1)>=0)
+		printf("se lee del extremo de escritura. NO DEBE APARECER\n");
+
+	if (crear_proceso("productor")<0)
+		printf("Error creando productor\n");
+
+	/* si no se cierra, nunca llegaria el fin de fichero */
+	cerrar_tuberia(descs[1]);
+
+	for (i=0; i<sizeof(tamanos)/sizeof(int); i++) {
+		t0=tiempos_proceso(0);
+		for (leidos=0; leidos<TOTAL; leidos+=n)
+			if ((n=leer_tuberia(descs[0], buf, tamanos[i]))<=0) {
+				printf("error leyendo. NO DEBE APARECER\n");
+				break;
+			}
+		t1=tiempos_proceso(0);
+
+		if (t1==t0)
+			t1++;
+		printf("mensajes de %5d bytes: %d ticks, %d MB/s\n", tamanos[i],
+			t1-t0, TOTAL/(t1-t0)*TICKS_SEG/(1024*1024));
+	}
+
+	if (leer_tuberia(descs[0], buf, 1)==0)
+		printf("fin de fichero al terminar productor. DEBE APARECER\n");
+
+	printf("prueba_tuberia termina\n");
+	return 0;
+}
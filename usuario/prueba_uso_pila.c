@@ -0,0 +1,61 @@
+/*
+ * usuario/prueba_uso_pila.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la medida del uso de pila. Ejecuta
+ * programas que usan poca pila (efimero), unos 24 KB (hondo) y unos
+ * 128 KB con una pila mayor (profundo), y muestra lo que mide el kernel
+ * de cada uno. Tambien mide un proceso vivo (inactivo).
+ */
+
+#include "servicios.h"
+
+static void mostrar(char *prog) {
+	struct uso_pila u;
+
+	if (uso_pila(prog, &u)<0)
+		printf("Error obteniendo el uso de pila de %s\n", prog);
+	else
+		printf("%-10s %d terminados, %d vivos: maximo %d bytes, medio %d bytes\n",
+			prog, u.procesos, u.vivos, u.maximo, u.medio);
+}
+
+int main(){
+	struct uso_pila u;
+	int fondo[2];
+	int i;
+
+	printf("prueba_uso_pila comienza\n");
+
+	if (uso_pila("no_existe", &u)>=0)
+		printf("programa no ejecutado. NO DEBE APARECER\n");
+
+	for (i=0; i<10; i++)
+		esperar_proceso(crear_proceso("efimero"), 0);
+	esperar_proceso(crear_proceso("hondo"), 0);
+	esperar_proceso(crear_proceso_con_pila("profundo", 256*1024), 0);
+
+	/* inactivo lee de la tuberia hasta el final */
+	crear_tuberia(fondo);
+	crear_proceso("inactivo");
+	dormir(1);
+
+	mostrar("efimero");
+	mostrar("hondo");
+	mostrar("profundo");
+	mostrar("inactivo");
+	mostrar("prueba_uso_pila");
+
+	cerrar_tuberia(fondo[1]);
+	cerrar_tuberia(fondo[0]);
+	esperar_hijo(0);
+
+	printf("prueba_uso_pila termina\n");
+	return 0;
+}
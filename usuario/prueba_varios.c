@@ -0,0 +1,93 @@
+/*
+ * usuario/prueba_varios.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de lock_varios. Primero
+ * comprueba que quien espera no retiene ninguno de los mutex pedidos y
+ * luego este proceso y cruzado toman "ma" y "mb" en ordenes opuestos
+ * sin llegar a interbloquearse. Por ultimo un hilo recibe un mutex por
+ * TRASPASO, lo devuelve al tener que esperar por otro y comprueba que
+ * solo cuenta como adquirido cuando los obtiene todos.
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 100
+
+static unsigned int descs_hilo[2];
+
+static int pedidor(void *arg) {
+	lock_varios(descs_hilo, 2);
+	unlock_varios(descs_hilo, 2);
+	return 0;
+}
+
+int main(){
+	unsigned int descs[2];
+	struct estad_mutex est;
+	int ma, mb, mc, md, i, j, pid;
+
+	printf("prueba_varios comienza\n");
+
+	/* con TRASPASO los dos procesos se alternan en vez de adelantarse */
+	if ((ma=crear_mutex("ma", NO_RECURSIVO|TRASPASO))<0)
+		printf("error creando ma. NO DEBE APARECER\n");
+	if ((mb=crear_mutex("mb", NO_RECURSIVO|TRASPASO))<0)
+		printf("error creando mb. NO DEBE APARECER\n");
+
+	descs[0]=ma;
+	descs[1]=ma;
+	if (lock_varios(descs, 2)<0)
+		printf("error con un mutex repetido. DEBE APARECER\n");
+	descs[1]=mb;
+	if (unlock_varios(descs, 2)<0)
+		printf("error soltando mutex que no tiene. DEBE APARECER\n");
+
+	lock(mb);
+	if (crear_proceso("cruzado")<0)
+		printf("Error creando cruzado\n");
+
+	/* cruzado queda esperando por mb; ma tiene que estar libre */
+	dormir(1);
+	lock(ma);
+	printf("prueba_varios obtiene ma en tick %d (DEBE SER ANTES QUE cruzado)\n",
+		tiempos_proceso(0));
+	unlock(ma);
+	unlock(mb);
+
+	for (i=0; i<ITERACIONES; i++) {
+		lock_varios(descs, 2);
+		for (j=0; j<1000000; j++);
+		unlock_varios(descs, 2);
+	}
+	printf("prueba_varios: %d iteraciones sin interbloqueo\n", ITERACIONES);
+
+	estadisticas_mutex(ma, &est);
+	printf("ma: %d adquisiciones, %d con espera\n", est.adquisiciones,
+		est.adquisiciones_con_espera);
+
+	mc=crear_mutex("mc", NO_RECURSIVO|TRASPASO);
+	md=crear_mutex("md", NO_RECURSIVO);
+	descs_hilo[0]=mc;
+	descs_hilo[1]=md;
+	lock(mc);
+	lock(md);
+	pid=crear_hilo(pedidor, 0);
+	dormir(1);	/* el hilo espera por mc */
+	unlock(mc);	/* se le cede */
+	dormir(1);	/* lo devuelve y espera por md */
+	unlock(md);
+	esperar_hilo(pid, 0);
+
+	estadisticas_mutex(mc, &est);
+	printf("mc: %d adquisiciones (DEBE SER 2)\n", est.adquisiciones);
+
+	printf("prueba_varios termina\n");
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * usuario/receptor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de regiones
+ * transferibles: comprueba cada region que recibe y la devuelve, y
+ * despues hace lo mismo con los datos que le llegan por las tuberias
+ * heredadas.
+ */
+
+#include "servicios.h"
+
+#define TAM_REGION (64*1024)
+#define ITERACIONES 2000
+#define PEDIDOS 0	/* tuberias heredadas de prueba_regiones */
+#define RESPUESTAS 3
+
+static char buf[TAM_REGION];
+
+/* las tuberias pueden devolver menos de lo pedido */
+static void leer_todo(int fd, void *buf, int tam) {
+	int n;
+
+	for (n=0; n<tam; n+=leer_tuberia(fd, (char *)buf+n, tam-n));
+}
+
+int main(){
+	int i, des, pid, tam;
+	int *datos;
+	void *dir;
+
+	cerrar_tuberia(1);
+	cerrar_tuberia(2);
+
+	pid=obtener_id_pr();
+	escribir_tuberia(RESPUESTAS, &pid, sizeof(pid));
+
+	for (i=0; i<ITERACIONES; i++) {
+		des=recibir_region(&dir, &tam, &pid);
+		datos=dir;
+		if (datos[TAM_REGION/sizeof(int)-1]!=TAM_REGION/sizeof(int)-1)
+			printf("datos de la region erroneos. NO DEBE APARECER\n");
+		datos[0]=datos[1];
+		transferir_region(des, pid);
+	}
+
+	for (i=0; i<ITERACIONES; i++) {
+		leer_todo(PEDIDOS, buf, TAM_REGION);
+		escribir_tuberia(RESPUESTAS, buf, TAM_REGION);
+	}
+
+	des=recibir_region(&dir, &tam, &pid);
+	printf("receptor: recibida la ultima region (%d KB)\n", tam/1024);
+	liberar_region(des);
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * usuario/saliente.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de espera por procesos
+ * hijos: termina con un estado que su padre puede comprobar.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int id;
+
+	id=obtener_id_pr();
+	printf("saliente (%d): termina con estado %d\n", id, id*10);
+	terminar_con_estado(id*10);
+	printf("saliente sigue tras terminar. NO DEBE APARECER\n");
+	return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * usuario/servidor_eco.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba del paso de mensajes:
+ * devuelve cada mensaje que recibe, primero con responder_y_recibir y
+ * despues a traves de las tuberias heredadas de prueba_mensajes. Tras la
+ * ultima respuesta intenta responder otra vez a la misma llamada
+ */
+
+#include "servicios.h"
+
+#define ITERACIONES 10000
+#define PEDIDOS 0	/* tuberias heredadas de prueba_mensajes */
+#define RESPUESTAS 3
+
+int main(){
+	char msg[TAM_MENSAJE];
+	int i, pid, tam;
+
+	cerrar_tuberia(1);
+	cerrar_tuberia(2);
+
+	pid=obtener_id_pr();
+	escribir_tuberia(RESPUESTAS, &pid, sizeof(pid));
+
+	pid=-1;
+	tam=recibir(&pid, msg, TAM_MENSAJE);
+	for (i=1; i<ITERACIONES; i++)
+		tam=responder_y_recibir(&pid, msg, tam);
+	responder(pid, msg, tam);
+	if (responder(pid, msg, tam)>=0)
+		printf("responde dos veces a la misma llamada. NO DEBE APARECER\n");
+
+	for (i=0; i<ITERACIONES; i++) {
+		tam=leer_tuberia(PEDIDOS, msg, TAM_MENSAJE);
+		escribir_tuberia(RESPUESTAS, msg, tam);
+	}
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+/*
+ * usuario/sumador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de memoria compartida:
+ * suma los enteros que prueba_segmento ha dejado en el segmento "datos" y
+ * deja el resultado en la ultima posicion
+ */
+
+#include "servicios.h"
+
+int main(){
+	int *datos;
+	int seg, sem, tam, i, n;
+	long suma=0;
+
+	if ((seg=asociar_segmento("datos", (void **)&datos, &tam))<0)
+		printf("error asociando datos. NO DEBE APARECER\n");
+	if ((sem=abrir_sem("hecho"))<0)
+		printf("error abriendo hecho. NO DEBE APARECER\n");
+
+	n=tam/sizeof(int)-1;
+	for (i=0; i<n; i++)
+		suma+=datos[i];
+	datos[n]=(int)suma;
+
+	printf("sumador (%d): %d enteros en %p\n", obtener_id_pr(), n, datos);
+	desasociar_segmento(seg);
+	senalar_sem(sem);
+	return 0;
+}